@@ -9,125 +9,322 @@
 
 #include "system.h"
 #include "tinygl.h"
-#include "ir_uart.h"
 #include "bullet.h"
 
 
-#define BOT_OF_MATRIX 4
+#ifdef __AVR__
+#define BULLET_TABLE const __flash // read straight from flash
+#else
+#define BULLET_TABLE const
+#endif
+
+
+/* The step in y of each boing_dir_t, N = 0 going clockwise. */
+#define BULLET_DY(dir) (((dir) >= DIR_SE && (dir) <= DIR_SW) - ((dir) == DIR_NW || (dir) <= DIR_NE))
+
+
+/* Where a bullet on row y goes next, as next_y << 3 | next_dir. A bullet
+ * that would leave the side of the mat bounces back off it instead. */
+#define BULLET_TURN(y, dir) ((y) + BULLET_DY (dir) < 0 || (y) + BULLET_DY (dir) >= TINYGL_HEIGHT \
+    ? (((y) - BULLET_DY (dir)) & 0x0F) << 3 | ((DIR_S - (dir)) & BULLET_DIR_MASK) \
+    : (((y) + BULLET_DY (dir)) & 0x0F) << 3 | (dir))
+
+
+#define BULLET_TURN_ROW(y) { \
+    BULLET_TURN (y, DIR_N), BULLET_TURN (y, DIR_NE), BULLET_TURN (y, DIR_E), BULLET_TURN (y, DIR_SE), \
+    BULLET_TURN (y, DIR_S), BULLET_TURN (y, DIR_SW), BULLET_TURN (y, DIR_W), BULLET_TURN (y, DIR_NW)}
+
+
+/* The bounce off the sides for every row and direction, worked out by the
+ * compiler. Rows past the bottom of the board are never reached. */
+static BULLET_TABLE uint8_t bullet_turn[16][8] = {
+    BULLET_TURN_ROW (0), BULLET_TURN_ROW (1), BULLET_TURN_ROW (2), BULLET_TURN_ROW (3),
+    BULLET_TURN_ROW (4), BULLET_TURN_ROW (5), BULLET_TURN_ROW (6), BULLET_TURN_ROW (7),
+    BULLET_TURN_ROW (8), BULLET_TURN_ROW (9), BULLET_TURN_ROW (10), BULLET_TURN_ROW (11),
+    BULLET_TURN_ROW (12), BULLET_TURN_ROW (13), BULLET_TURN_ROW (14), BULLET_TURN_ROW (15),
+};
 
 
 /**
  * Sends bullet information to other player when bullet leaves LED mat.
  * Information sent consists of position and directon of travel.
- * @param bullet - The bullet to be 'sent' across to the enemy funkit
+ * @param bullet - A pointer to the bullet to be 'sent' across to the enemy funkit
+ * @param tx - A pointer to the packet transmit queue
  */
-void send_bullet (Bullet bullet)
+void send_bullet (const Bullet* bullet, Packet_Tx* tx)
 {
-    uint8_t bullet_info = bullet.bullet_data.pos.y + COL1;
-    boing_dir_t bul_dir = bullet.bullet_data.dir;
+    uint8_t bullet_info = PACKET_EVENT_BULLET | (bullet->bullet_data.pos.y & PACKET_COLUMN_MASK);
+    boing_dir_t bul_dir = bullet->bullet_data.dir;
 
     if (bul_dir == DIR_NW) {
-        bullet_info = bullet_info + DIR_LEFT;
+        bullet_info = bullet_info | (DIR_LEFT << 4);
 
     } else if (bul_dir == DIR_SW) {
-        bullet_info = bullet_info + DIR_RIGHT;
+        bullet_info = bullet_info | (DIR_RIGHT << 4);
     }
 
-    ir_uart_putc(bullet_info);
+    packet_queue(tx, bullet_info);
 }
 
 
 /**
- * Updates all the bullets as they travel across the LED mat if they are active.
- * Deletes bullets that reach the bottom or top of the LED matrix.
- * @param bullets - The array of bullets that are in the game
+ * Empties the bullet pool.
+ * @param pool - A pointer to the bullet pool
  */
-void update_bullets (Bullet* bullets)
+void bullet_pool_init (Bullet_Pool* pool)
 {
-    int i;
-
-    for (i = 0; i < MAX_BULLET_COUNT; i++) {
-        if (bullets[i].deleted == ACTIVE ) {
-            tinygl_draw_point (bullets[i].bullet_data.pos, 0);
-            if (bullets[i].bullet_data.pos.x == BOT_OF_MATRIX) {
-                bullets[i].deleted = 1;
-
-            } else if ((bullets[i].bullet_data.pos.x > 0 ||
-                        bullets[i].bullet_data.dir == DIR_E ||
-                        bullets[i].bullet_data.dir == DIR_NE ||
-                        bullets[i].bullet_data.dir == DIR_SE) &&
-                        bullets[i].deleted == 0) {
-
-                bullets[i].bullet_data = boing_update (bullets[i].bullet_data);
-                tinygl_draw_point (bullets[i].bullet_data.pos, 1);
-
-            } else {
-                bullets[i].bullet_data.pos.x = -1; // Sets the bullet off screen
-
-                if (bullets[i].deleted == ACTIVE) {
-                    send_bullet(bullets[i]);
-                    bullets[i].deleted = DELETED;
-                }
-            }
-        }
+    pool->count = 0;
+    pool->overflow_count = 0;
+    playfield_clear (&pool->field);
+}
+
+
+/**
+ * Unpacks a bullet from the pool.
+ * @param pool - A pointer to the bullet pool
+ * @param i - The index of a live bullet
+ * @return The bullet
+ */
+Bullet bullet_get (const Bullet_Pool* pool, bullet_index_t i)
+{
+    Bullet bullet;
+
+    bullet.bullet_data.pos.x = bullet_pos_x (pool->pos[i]);
+    bullet.bullet_data.pos.y = bullet_pos_y (pool->pos[i]);
+    bullet.bullet_data.dir = pool->state[i] & BULLET_DIR_MASK;
+
+    return bullet;
+}
+
+
+/**
+ * Moves a batch of bullets one step, bouncing off the sides of the LED
+ * mat. Bullets that reach the bottom row or leave the top lose BULLET_LIVE,
+ * and those leaving the top are marked BULLET_EXITED and keep their last
+ * position and direction so they can be sent.
+ * The new row and direction are looked up in bullet_turn, the step in x
+ * of each boing_dir_t (N = 0 going clockwise) is worked out with
+ * arithmetic, and the loop has no calls or branches.
+ * @param pos - The packed positions
+ * @param state - The packed states
+ * @param count - The number of bullets
+ */
+void bullet_step_batch (bullet_pos_t* restrict pos, uint8_t* restrict state, bullet_index_t count)
+{
+    for (bullet_index_t i = 0; i < count; i++) {
+        bullet_pos_t old_pos = pos[i];
+        uint8_t old_state = state[i];
+        int8_t x = bullet_pos_x (old_pos);
+        int8_t y = bullet_pos_y (old_pos);
+        uint8_t dir = old_state & BULLET_DIR_MASK;
+        int8_t dx = ((uint8_t) (dir - DIR_NE) < 3) - ((uint8_t) (dir - DIR_SW) < 3);
+        uint8_t turn = bullet_turn[y & 0x0F][dir];
+        uint8_t at_bottom = x == BOT_OF_MATRIX;
+        int8_t moving = -((at_bottom ^ 1) & ((x > 0) | (dx > 0))); // all ones while moving
+
+        bullet_pos_t moved_pos = bullet_pack_pos (x + dx, turn >> 3);
+        uint8_t moved_state = (turn & BULLET_DIR_MASK) | BULLET_LIVE;
+        uint8_t stopped_state = (old_state & BULLET_DIR_MASK) | BULLET_EXITED;
+
+        stopped_state &= at_bottom - 1; // nothing left to send from the bottom row
+        pos[i] = old_pos ^ ((old_pos ^ moved_pos) & moving);
+        state[i] = stopped_state ^ ((stopped_state ^ moved_state) & moving);
     }
 }
 
 
 /**
- * Creates a bullet ath position x and y with a direction.
- * @param x - The x direction for the bullet to appear in
- * @param y - The y direction for the bullet to appear in
- * @param bullets - A pointer to the array of bullets that are in the game
- * @param bullet_index - A pointer to the integer of the current bullet_index
+ * Returns the number of steps a bullet can still move before it stops,
+ * by leaving the top of the LED mat or reaching the bottom row.
+ * @param pos - The packed position
+ * @param state - The packed state
+ * @return The number of steps, or 255 for a bullet moving N or S, which
+ * never stops
  */
-void create_bullet (uint8_t x, uint8_t y, boing_dir_t direction, Bullet* bullets, uint8_t* bullet_index)
+uint8_t bullet_steps_left (bullet_pos_t pos, uint8_t state)
 {
-    boing_state_t bullet_position = boing_init (x, y, direction);
+    uint8_t x = bullet_pos_x (pos);
+    uint8_t dir = state & BULLET_DIR_MASK;
 
-    Bullet bullet;
-    bullet.bullet_data = bullet_position;
-    bullet.deleted = 0;
-    bullets[*bullet_index] = bullet;
+    if (x == BOT_OF_MATRIX) {
+        return 0;
+
+    } else if (dir >= DIR_NE && dir <= DIR_SE) {
+        return BOT_OF_MATRIX - x;
 
-    tinygl_draw_point (bullets[*bullet_index].bullet_data.pos, 1);
+    } else if (dir >= DIR_SW && dir <= DIR_NW) {
+        return x;
+    }
+
+    return x > 0 ? 255 : 0;
+}
 
-    *bullet_index = *bullet_index + 1;
 
-    if (*bullet_index >= MAX_BULLET_COUNT) {
-        *bullet_index = 0;
+/**
+ * Moves a bullet on a number of steps at once, ending where that many
+ * calls to bullet_step_batch would. Bouncing between the sides of the
+ * mat repeats every 2 * (TINYGL_HEIGHT - 1) steps, so the row is found
+ * by unfolding the bounces into a phase along that cycle.
+ * @param pos - The packed position, moved on
+ * @param state - The packed state, moved on
+ * @param steps - The number of steps
+ */
+void bullet_advance (bullet_pos_t* pos, uint8_t* state, uint16_t steps)
+{
+    uint8_t left = bullet_steps_left (*pos, *state);
+    uint16_t moves = steps < left || left == 255 ? steps : left;
+    int8_t x = bullet_pos_x (*pos);
+    int8_t y = bullet_pos_y (*pos);
+    uint8_t dir = *state & BULLET_DIR_MASK;
+    int8_t dx = (dir >= DIR_NE && dir <= DIR_SE) - (dir >= DIR_SW && dir <= DIR_NW);
+    int8_t dy = BULLET_DY (dir);
+    uint8_t cycle = 2 * (TINYGL_HEIGHT - 1);
+
+    if (moves == 0) {
+        bullet_step_batch (pos, state, steps > 0);
+        return;
     }
+
+    if (dy != 0) {
+        /* Phases 1 to TINYGL_HEIGHT - 1 are on the way down (dy > 0) and
+         * the rest on the way up. */
+        uint8_t phase = (dy > 0 ? y : cycle - y) % cycle;
+
+        phase = (phase + moves % cycle) % cycle;
+        y = phase < TINYGL_HEIGHT ? phase : cycle - phase;
+
+        if ((phase > 0 && phase < TINYGL_HEIGHT) != (dy > 0)) {
+            dir = (DIR_S - dir) & BULLET_DIR_MASK;
+        }
+    }
+
+    *pos = bullet_pack_pos (x + dx * moves, y);
+    *state = dir | BULLET_LIVE;
+
+    /* One step more stops the bullet. */
+    bullet_step_batch (pos, state, steps > moves);
 }
 
 
 /**
- * Checks each bullet in the game to see if they have collided
- * with the ship
- * @param ship_pos - The current position of the ship
- * @param bullets - The array of bullets tha are in the game
- * @return COLLISION if there has been a collision. NO_COLLISION otherwise
+ * Removes the bullet at an index by moving the last bullet into its place.
+ * @param pool - A pointer to the bullet pool
+ * @param i - The index of the bullet
+ */
+static void delete_bullet (Bullet_Pool* pool, bullet_index_t i)
+{
+    pool->count--;
+    pool->pos[i] = pool->pos[pool->count];
+    pool->state[i] = pool->state[pool->count];
+}
+
+
+/**
+ * Updates all the active bullets as they travel across the LED mat.
+ * Deletes bullets that reach the bottom or top of the LED matrix.
+ * The bullet field is rebuilt and only the pixels that changed are redrawn.
+ * Bullets leaving the top are queued for sending.
+ * @param pool - A pointer to the bullet pool
+ * @param tx - A pointer to the packet transmit queue
+ * @param fb - A pointer to the framebuffer
  */
-uint8_t collision_check (tinygl_point_t ship_pos, Bullet* bullets)
+void update_bullets (Bullet_Pool* pool, Packet_Tx* tx, Framebuffer* fb)
 {
-    for (int i = 0 ; i < MAX_BULLET_COUNT ; i++) {
-        if (bullets[i].deleted == ACTIVE && bullets[i].bullet_data.pos.x == BOT_OF_MATRIX) {
-            if (bullets[i].bullet_data.pos.y == ship_pos.y) {
-                return COLLISION;
+    bullet_index_t i = 0;
+    Playfield shown = pool->field;
+
+    bullet_step_batch (pool->pos, pool->state, pool->count);
+    playfield_clear (&pool->field);
+
+    while (i < pool->count) {
+        if (pool->state[i] & BULLET_LIVE) {
+            playfield_set (&pool->field, tinygl_point (bullet_pos_x (pool->pos[i]), bullet_pos_y (pool->pos[i])));
+            i++;
+
+        } else {
+            if (pool->state[i] & BULLET_EXITED) {
+                Bullet bullet = bullet_get (pool, i);
+                send_bullet(&bullet, tx);
             }
+            delete_bullet (pool, i);
         }
     }
 
-    return NO_COLLISION;
+    framebuffer_draw_change (fb, &shown, &pool->field);
 }
 
 
+/**
+ * Creates a bullet ath position x and y with a direction.
+ * @param x - The x direction for the bullet to appear in
+ * @param y - The y direction for the bullet to appear in
+ * @param pool - A pointer to the bullet pool
+ * @param fb - A pointer to the framebuffer
+ * @return BULLET_OK, or BULLET_POOL_FULL if there was no free slot
+ */
+uint8_t create_bullet (uint8_t x, uint8_t y, boing_dir_t direction, Bullet_Pool* pool, Framebuffer* fb)
+{
+    if (pool->count == MAX_BULLET_COUNT) {
+        pool->overflow_count++;
+        return BULLET_POOL_FULL;
+    }
+
+    pool->pos[pool->count] = bullet_pack_pos (x, y);
+    pool->state[pool->count] = direction | BULLET_LIVE;
+    pool->count++;
+
+    playfield_set (&pool->field, tinygl_point (x, y));
+    framebuffer_draw_point (fb, tinygl_point (x, y), 1);
 
+    return BULLET_OK;
+}
 
 
+/**
+ * Creates a bullet that should have appeared some bullet steps ago and
+ * moves it on to where it would be now. A bullet that reaches the bottom
+ * row stops there, and is checked against the ship as collision_check
+ * would have done on the steps it missed.
+ * @param x - The x position the bullet should have appeared at
+ * @param y - The y position the bullet should have appeared at
+ * @param direction - The direction the bullet should have appeared with
+ * @param steps - The number of bullet steps it missed
+ * @param ship_pos - The current position of the ship
+ * @param pool - A pointer to the bullet pool
+ * @param fb - A pointer to the framebuffer
+ * @return BULLET_HIT if the bullet has hit the ship, otherwise as create_bullet
+ */
+uint8_t create_late_bullet (uint8_t x, uint8_t y, boing_dir_t direction, uint8_t steps,
+                            tinygl_point_t ship_pos, Bullet_Pool* pool, Framebuffer* fb)
+{
+    bullet_pos_t pos = bullet_pack_pos (x, y);
+    uint8_t state = direction | BULLET_LIVE;
+    uint8_t status;
 
+    bullet_advance (&pos, &state, steps);
 
+    status = create_bullet (bullet_pos_x (pos), bullet_pos_y (pos), state & BULLET_DIR_MASK, pool, fb);
 
+    if (bullet_pos_x (pos) == BOT_OF_MATRIX && bullet_pos_y (pos) == ship_pos.y) {
+        return BULLET_HIT;
+    }
 
+    return status;
+}
 
 
+/**
+ * Checks the bottom row of the bullet field to see if a bullet has
+ * collided with the ship
+ * @param ship_pos - The current position of the ship
+ * @param pool - A pointer to the bullet pool
+ * @return COLLISION if there has been a collision. NO_COLLISION otherwise
+ */
+uint8_t collision_check (tinygl_point_t ship_pos, const Bullet_Pool* pool)
+{
+    if (pool->field.cols[BOT_OF_MATRIX] & playfield_row_mask (ship_pos.y)) {
+        return COLLISION;
+    }
 
+    return NO_COLLISION;
+}
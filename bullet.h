@@ -12,18 +12,36 @@
 
 #include "system.h"
 #include "boing.h"
+#include "playfield.h"
+#include "framebuffer.h"
+#include "packet.h"
+#include "geometry.h"
 
 
-#define MAX_BULLET_COUNT 10
+#if MAX_BULLET_COUNT > 255
+typedef uint16_t bullet_index_t;
+#else
+typedef uint8_t bullet_index_t;
+#endif
+
+
+/* Up to a 16x8 board a bullet position fits in one byte. */
+#if TINYGL_WIDTH <= 16 && TINYGL_HEIGHT <= 8
+typedef uint8_t bullet_pos_t;
+#define BULLET_POS_BITS 4
+#else
+typedef uint16_t bullet_pos_t;
+#define BULLET_POS_BITS 8
+#endif
 
 
-typedef enum col_num {COL1 = 'A', COL2 = 'B', COL3 = 'C', COL4 = 'D', COL5 = 'E', COL6 = 'F', COL7 = 'G'} col_num_t;
+#define BULLET_POS_Y_MASK ((1 << BULLET_POS_BITS) - 1)
 
 
-typedef enum dir_num {DIR_LEFT = 10, DIR_RIGHT = 20} dir_num_t;
+typedef enum dir_num {DIR_STRAIGHT, DIR_LEFT, DIR_RIGHT} dir_num_t;
 
 
-typedef enum deleted_bullet {ACTIVE, DELETED} del_bul_t;
+typedef enum bullet_status {BULLET_OK, BULLET_POOL_FULL, BULLET_HIT} bullet_status_t;
 
 
 typedef enum collided {NO_COLLISION, COLLISION} collided_t;
@@ -32,47 +50,176 @@ typedef enum collided {NO_COLLISION, COLLISION} collided_t;
 typedef struct bullet_s Bullet;
 
 
+typedef struct bullet_pool_s Bullet_Pool;
+
+
 struct bullet_s
 {
     boing_state_t bullet_data;
-    uint8_t deleted;
 };
 
 
+#define BULLET_DIR_MASK 0x07 // boing_dir_t in the low bits of a bullet state
+#define BULLET_LIVE 0x08 // set while the bullet is on the LED mat
+#define BULLET_EXITED 0x10 // set when the bullet left the top of the LED mat
+
+
+/* Live bullets are kept packed at the front of two parallel arrays, so
+ * creating a bullet appends and deleting one moves the last bullet into
+ * its place. Each position holds x in the high BULLET_POS_BITS and y as a
+ * signed number in the low BULLET_POS_BITS, each state byte holds the
+ * direction and flags. The
+ * field has a bit set for every cell holding at least one bullet. */
+struct bullet_pool_s
+{
+    bullet_pos_t pos[MAX_BULLET_COUNT];
+    uint8_t state[MAX_BULLET_COUNT];
+    bullet_index_t count;
+    Playfield field;
+    uint16_t overflow_count; // bullets refused because the pool was full
+};
+
+
+/**
+ * Packs a position into a bullet position.
+ * @param x - The x position, 0 to 15 on boards that pack into a byte
+ * @param y - The y position, -8 to 7 on boards that pack into a byte
+ * @return The packed position
+ */
+static inline bullet_pos_t bullet_pack_pos (tinygl_coord_t x, tinygl_coord_t y)
+{
+    return ((bullet_pos_t) x << BULLET_POS_BITS) | (y & BULLET_POS_Y_MASK);
+}
+
+
+/**
+ * Returns the x position of a packed bullet position.
+ * @param pos - The packed position
+ * @return The x position
+ */
+static inline tinygl_coord_t bullet_pos_x (bullet_pos_t pos)
+{
+    return pos >> BULLET_POS_BITS;
+}
+
+
+/**
+ * Returns the y position of a packed bullet position.
+ * @param pos - The packed position
+ * @return The y position
+ */
+static inline tinygl_coord_t bullet_pos_y (bullet_pos_t pos)
+{
+    return (int8_t) (pos << (8 - BULLET_POS_BITS)) >> (8 - BULLET_POS_BITS);
+}
+
+
+/**
+ * Unpacks a bullet from the pool.
+ * @param pool - A pointer to the bullet pool
+ * @param i - The index of a live bullet
+ * @return The bullet
+ */
+Bullet bullet_get (const Bullet_Pool* pool, bullet_index_t i);
+
+
+/**
+ * Moves a batch of bullets one step, bouncing off the sides of the LED
+ * mat. Bullets that reach the bottom row or leave the top lose BULLET_LIVE,
+ * and those leaving the top are marked BULLET_EXITED and keep their last
+ * position and direction so they can be sent.
+ * @param pos - The packed positions
+ * @param state - The packed states
+ * @param count - The number of bullets
+ */
+void bullet_step_batch (bullet_pos_t* pos, uint8_t* state, bullet_index_t count);
+
+
+/**
+ * Returns the number of steps a bullet can still move before it stops,
+ * by leaving the top of the LED mat or reaching the bottom row.
+ * @param pos - The packed position
+ * @param state - The packed state
+ * @return The number of steps, or 255 for a bullet moving N or S, which
+ * never stops
+ */
+uint8_t bullet_steps_left (bullet_pos_t pos, uint8_t state);
+
+
+/**
+ * Moves a bullet on a number of steps at once, ending where that many
+ * calls to bullet_step_batch would.
+ * @param pos - The packed position, moved on
+ * @param state - The packed state, moved on
+ * @param steps - The number of steps
+ */
+void bullet_advance (bullet_pos_t* pos, uint8_t* state, uint16_t steps);
+
+
+/**
+ * Empties the bullet pool.
+ * @param pool - A pointer to the bullet pool
+ */
+void bullet_pool_init (Bullet_Pool* pool);
+
+
 /**
  * Sends bullet information to other player when bullet leaves LED mat.
  * Information sent consists of position and directon of travel.
- * @param bullet - The bullet to be 'sent' across to the enemy funkit
+ * @param bullet - A pointer to the bullet to be 'sent' across to the enemy funkit
+ * @param tx - A pointer to the packet transmit queue
  */
-void send_bullet (Bullet bullet);
+void send_bullet (const Bullet* bullet, Packet_Tx* tx);
 
 
 /**
- * Updates all the bullets as they travel across the LED mat if they are active.
+ * Updates all the active bullets as they travel across the LED mat.
  * Deletes bullets that reach the bottom or top of the LED matrix.
- * @param bullets - The array of bullets that are in the game
+ * Bullets leaving the top are queued for sending.
+ * @param pool - A pointer to the bullet pool
+ * @param tx - A pointer to the packet transmit queue
+ * @param fb - A pointer to the framebuffer
  */
-void update_bullets(Bullet* bullets);
+void update_bullets(Bullet_Pool* pool, Packet_Tx* tx, Framebuffer* fb);
 
 
 /**
  * Creates a bullet ath position x and y with a direction.
  * @param x - The x direction for the bullet to appear in
  * @param y - The y direction for the bullet to appear in
- * @param bullets - A pointer to the array of bullets that are in the game
- * @param bullet_index - A pointer to the integer of the current bullet_index
+ * @param pool - A pointer to the bullet pool
+ * @param fb - A pointer to the framebuffer
+ * @return BULLET_OK, or BULLET_POOL_FULL if there was no free slot
+ */
+uint8_t create_bullet (uint8_t x, uint8_t y, boing_dir_t direction, Bullet_Pool* pool, Framebuffer* fb);
+
+
+/**
+ * Creates a bullet that should have appeared some bullet steps ago and
+ * moves it on to where it would be now. A bullet that reaches the bottom
+ * row stops there, and is checked against the ship as collision_check
+ * would have done on the steps it missed.
+ * @param x - The x position the bullet should have appeared at
+ * @param y - The y position the bullet should have appeared at
+ * @param direction - The direction the bullet should have appeared with
+ * @param steps - The number of bullet steps it missed
+ * @param ship_pos - The current position of the ship
+ * @param pool - A pointer to the bullet pool
+ * @param fb - A pointer to the framebuffer
+ * @return BULLET_HIT if the bullet has hit the ship, otherwise as create_bullet
  */
-void create_bullet (uint8_t x, uint8_t y, boing_dir_t direction, Bullet* bullets, uint8_t* bullet_index);
+uint8_t create_late_bullet (uint8_t x, uint8_t y, boing_dir_t direction, uint8_t steps,
+                            tinygl_point_t ship_pos, Bullet_Pool* pool, Framebuffer* fb);
 
 
 /**
- * Checks each bullet in the game to see if they have collided
- * with the ship
+ * Checks the bottom row of the bullet field to see if a bullet has
+ * collided with the ship
  * @param ship_pos - The current position of the ship
- * @param bullets - The array of bullets tha are in the game
+ * @param pool - A pointer to the bullet pool
  * @return COLLISION if there has been a collision. NO_COLLISION otherwise
  */
-uint8_t collision_check (tinygl_point_t ship_pos, Bullet* bullets);
+uint8_t collision_check (tinygl_point_t ship_pos, const Bullet_Pool* pool);
 
 
 #endif
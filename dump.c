@@ -0,0 +1,30 @@
+/** @file dump.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 18 Nov 19
+ *  @brief Writes numbers over the IR UART.
+ */
+
+
+#include "system.h"
+#include "ir_uart.h"
+#include "dump.h"
+
+
+/**
+ * Writes an unsigned number in decimal over the IR UART.
+ * @param value - The number
+ */
+void dump_u32 (uint32_t value)
+{
+    char digits[10];
+    uint8_t len = 0;
+
+    do {
+        digits[len++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+
+    while (len > 0) {
+        ir_uart_putc (digits[--len]);
+    }
+}
@@ -0,0 +1,23 @@
+/** @file dump.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 18 Nov 19
+ *  @brief Writes numbers over the IR UART for the PROFILE and LATENCY
+ *  dumps on the funkit.
+ */
+
+
+#ifndef DUMP_H
+#define DUMP_H
+
+
+#include "system.h"
+
+
+/**
+ * Writes an unsigned number in decimal over the IR UART.
+ * @param value - The number
+ */
+void dump_u32 (uint32_t value);
+
+
+#endif
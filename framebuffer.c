@@ -0,0 +1,136 @@
+/** @file framebuffer.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 6 Nov 19
+ *  @brief An in-game framebuffer in front of tinygl.
+ */
+
+
+#include "system.h"
+#include "tinygl.h"
+#include "framebuffer.h"
+
+
+/**
+ * Empties the framebuffer and resets its counters.
+ * @param fb - A pointer to the framebuffer
+ */
+void framebuffer_init (Framebuffer* fb)
+{
+    playfield_clear (&fb->next);
+    playfield_clear (&fb->shown);
+    fb->dirty = 0;
+    fb->draw_count = 0;
+    fb->write_count = 0;
+}
+
+
+/**
+ * Draws a single pixel into the next frame. Points off the LED mat are
+ * ignored.
+ * @param fb - A pointer to the framebuffer
+ * @param point - The pixel to draw
+ * @param pixel_value - 1 to light, 0 to clear
+ */
+void framebuffer_draw_point (Framebuffer* fb, tinygl_point_t point, tinygl_pixel_value_t pixel_value)
+{
+    if (!playfield_contains (point)) {
+        return;
+    }
+
+    if (pixel_value) {
+        fb->next.cols[point.x] |= playfield_row_mask (point.y);
+    } else {
+        fb->next.cols[point.x] &= ~playfield_row_mask (point.y);
+    }
+
+    fb->dirty |= (framebuffer_dirty_t) 1 << point.x;
+    fb->draw_count++;
+}
+
+
+/**
+ * Replaces a whole column of the next frame. Columns off the LED mat are
+ * ignored.
+ * @param fb - A pointer to the framebuffer
+ * @param x - The column
+ * @param bits - The column's pixels, bit y set to light row y
+ */
+void framebuffer_draw_column (Framebuffer* fb, tinygl_coord_t x, playfield_col_t bits)
+{
+    if (x < 0 || x >= TINYGL_WIDTH) {
+        return;
+    }
+
+    fb->next.cols[x] = bits;
+    fb->dirty |= (framebuffer_dirty_t) 1 << x;
+    fb->draw_count += TINYGL_HEIGHT;
+}
+
+
+/**
+ * Applies the change between two playfields to the next frame, so pixels
+ * lit only in the old one are cleared and pixels lit only in the new one
+ * are drawn.
+ * @param fb - A pointer to the framebuffer
+ * @param old_field - A pointer to the old playfield
+ * @param new_field - A pointer to the new playfield
+ */
+void framebuffer_draw_change (Framebuffer* fb, const Playfield* old_field, const Playfield* new_field)
+{
+    uint8_t x;
+
+    for (x = 0; x < TINYGL_WIDTH; x++) {
+        playfield_col_t changed = old_field->cols[x] ^ new_field->cols[x];
+
+        if (changed != 0) {
+            fb->next.cols[x] = (fb->next.cols[x] & ~changed) | (new_field->cols[x] & changed);
+            fb->dirty |= (framebuffer_dirty_t) 1 << x;
+        }
+
+        /* Each pixel that changed is one draw. */
+        for (; changed != 0; changed &= changed - 1) {
+            fb->draw_count++;
+        }
+    }
+}
+
+
+/**
+ * Clears the display and both frames straight away.
+ * @param fb - A pointer to the framebuffer
+ */
+void framebuffer_clear (Framebuffer* fb)
+{
+    tinygl_clear ();
+    playfield_clear (&fb->next);
+    playfield_clear (&fb->shown);
+    fb->dirty = 0;
+}
+
+
+/**
+ * Writes the pixels that changed in the dirty columns to tinygl.
+ * @param fb - A pointer to the framebuffer
+ */
+void framebuffer_flush (Framebuffer* fb)
+{
+    uint8_t x;
+    uint8_t y;
+
+    for (x = 0; fb->dirty != 0; x++, fb->dirty >>= 1) {
+        playfield_col_t changed = fb->shown.cols[x] ^ fb->next.cols[x];
+
+        if (!(fb->dirty & 1) || changed == 0) {
+            continue;
+        }
+
+        for (y = 0; changed != 0; y++, changed >>= 1) {
+            if (changed & 1) {
+                tinygl_draw_point (tinygl_point (x, y), (fb->next.cols[x] >> y) & 1);
+                fb->write_count++;
+            }
+        }
+
+        fb->shown.cols[x] = fb->next.cols[x];
+    }
+}
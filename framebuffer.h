@@ -0,0 +1,97 @@
+/** @file framebuffer.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 6 Nov 19
+ *  @brief An in-game framebuffer in front of tinygl. Draws during a tick
+ *  only change the next frame, so an erase followed by a redraw of the
+ *  same pixel costs nothing. Once per display tick the columns that were
+ *  drawn into are compared with what is on the display and only the
+ *  pixels that changed are written to tinygl.
+ */
+
+
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+
+#include "system.h"
+#include "tinygl.h"
+#include "playfield.h"
+
+
+#if TINYGL_WIDTH <= 8
+typedef uint8_t framebuffer_dirty_t;
+#elif TINYGL_WIDTH <= 16
+typedef uint16_t framebuffer_dirty_t;
+#elif TINYGL_WIDTH <= 32
+typedef uint32_t framebuffer_dirty_t;
+#else
+typedef uint64_t framebuffer_dirty_t;
+#endif
+
+
+typedef struct framebuffer_s Framebuffer;
+
+
+struct framebuffer_s
+{
+    Playfield next; // the frame being drawn
+    Playfield shown; // the frame on the display
+    framebuffer_dirty_t dirty; // bit x set when column x has been drawn into
+    uint32_t draw_count; // pixels drawn into the framebuffer
+    uint32_t write_count; // pixels written to tinygl
+};
+
+
+/**
+ * Empties the framebuffer and resets its counters.
+ * @param fb - A pointer to the framebuffer
+ */
+void framebuffer_init (Framebuffer* fb);
+
+
+/**
+ * Draws a single pixel into the next frame. Points off the LED mat are
+ * ignored.
+ * @param fb - A pointer to the framebuffer
+ * @param point - The pixel to draw
+ * @param pixel_value - 1 to light, 0 to clear
+ */
+void framebuffer_draw_point (Framebuffer* fb, tinygl_point_t point, tinygl_pixel_value_t pixel_value);
+
+
+/**
+ * Replaces a whole column of the next frame. Columns off the LED mat are
+ * ignored.
+ * @param fb - A pointer to the framebuffer
+ * @param x - The column
+ * @param bits - The column's pixels, bit y set to light row y
+ */
+void framebuffer_draw_column (Framebuffer* fb, tinygl_coord_t x, playfield_col_t bits);
+
+
+/**
+ * Applies the change between two playfields to the next frame, so pixels
+ * lit only in the old one are cleared and pixels lit only in the new one
+ * are drawn.
+ * @param fb - A pointer to the framebuffer
+ * @param old_field - A pointer to the old playfield
+ * @param new_field - A pointer to the new playfield
+ */
+void framebuffer_draw_change (Framebuffer* fb, const Playfield* old_field, const Playfield* new_field);
+
+
+/**
+ * Clears the display and both frames straight away.
+ * @param fb - A pointer to the framebuffer
+ */
+void framebuffer_clear (Framebuffer* fb);
+
+
+/**
+ * Writes the pixels that changed in the dirty columns to tinygl.
+ * @param fb - A pointer to the framebuffer
+ */
+void framebuffer_flush (Framebuffer* fb);
+
+
+#endif
@@ -6,60 +6,26 @@
 
 
 #include "system.h"
-#include "pacer.h"
 #include "tinygl.h"
 #include "navswitch.h"
-#include "task.h"
+#include "timer.h"
+#include "idle.h"
 #include "ir_uart.h"
 #include "game_data.h"
-#include "../fonts/font5x5_1.h"
+#include "game_sim.h"
+#include "profile.h"
+#include "latency.h"
 
 
-#define DISPLAY_RATE 500
-#define INPUT_RATE 100
-#define BULLET_MOVE_RATE 5
-#define CHECK_RATE 100
-#define COOLDOWN_RATE 3
-#define MESSAGE_RATE 20
+#define GAME_TICK_PERIOD (IDLE_TIMER_RATE / GAME_TICK_RATE) // timer ticks per game tick
 
 
 static Game_Data game_data;
 
 
-/**
- * Initializes the move bullet task.
- */
-static void bullet_move_task_init (void)
-{
-    game_data.bullet_index = 0;
-}
-
-
-/**
- * Calls a task responsible for checking if there are any incoming signals.
- */
-static void check_incoming_signal_task (__unused__ void *data)
-{
-    char received_sig = check_incoming_signal();
-    process_signal(&game_data, received_sig);
-
-}
-
-
-/**
- * Calls a task responsible for moving all bullets that have been shot.
- * It also checks whether or not the bullet has collided into the ship
- */
-static void bullet_move_task (__unused__ void *data)
-{
-    update_bullets(game_data.bullets);
-
-    uint8_t collided = collision_check(game_data.ship.ship_pos, game_data.bullets);
-
-    if (collided == COLLISION) {
-        own_ship_hit(&game_data);
-    }
-}
+#ifdef REPLAY
+static Replay_Log replay_log;
+#endif
 
 
 /**
@@ -72,47 +38,36 @@ static void navswitch_task_init (void)
 
 
 /**
- * Calls a task that checks for navswitch input. If input detected an action is preformed.
- * If the current state is playing, then the navswitch controls the ship
- * If the current state is score screen, then the navswitch controls the
- * starting of the next round.
+ * Polls the navswitch and returns the switches that have been pushed.
+ * @return The nav_event_t flags for the pushed switches
  */
-static void navswitch_task (__unused__ void *data)
+static uint8_t navswitch_read_events (void)
 {
-    navswitch_update ();
+    uint8_t nav_events = 0;
 
-    if (game_data.state == STATE_PLAYING) {
-        if (navswitch_push_event_p (NAVSWITCH_NORTH)) {
-            ship_move_right (&game_data.ship, game_data.ready);
-        }
+    navswitch_update ();
 
-        if (navswitch_push_event_p (NAVSWITCH_SOUTH)) {
-            ship_move_left (&game_data.ship, game_data.ready);
-        }
+    if (navswitch_push_event_p (NAVSWITCH_NORTH)) {
+        nav_events |= NAV_NORTH;
+    }
 
-        if (navswitch_push_event_p (NAVSWITCH_EAST)) {
-            ship_aim_right (&game_data.ship, game_data.ready);
-        }
+    if (navswitch_push_event_p (NAVSWITCH_SOUTH)) {
+        nav_events |= NAV_SOUTH;
+    }
 
-        if (navswitch_push_event_p (NAVSWITCH_WEST)) {
-            ship_aim_left (&game_data.ship, game_data.ready);
-        }
+    if (navswitch_push_event_p (NAVSWITCH_EAST)) {
+        nav_events |= NAV_EAST;
+    }
 
-        if (navswitch_push_event_p (NAVSWITCH_PUSH)) {
-            if (game_data.ready == READY) {
-                shoot_bullet(&game_data);
-            }
-        }
+    if (navswitch_push_event_p (NAVSWITCH_WEST)) {
+        nav_events |= NAV_WEST;
+    }
 
-    } else if (game_data.state == STATE_SCORE) {
-        if (navswitch_push_event_p (NAVSWITCH_PUSH)) {
-            game_data.state = STATE_PLAYING;
-            tinygl_clear();
-            show_ship(&game_data.ship, game_data.ready);
-            pio_output_low(LED1_PIO);
-            ir_uart_putc(ENEMY_HIT);
-        }
+    if (navswitch_push_event_p (NAVSWITCH_PUSH)) {
+        nav_events |= NAV_PUSH;
     }
+
+    return nav_events;
 }
 
 
@@ -122,37 +77,44 @@ static void navswitch_task (__unused__ void *data)
 static void display_task_init (void)
 {
     tinygl_init (DISPLAY_RATE);
-    tinygl_font_set (&font5x5_1);
-    tinygl_text_speed_set (MESSAGE_RATE);
-    tinygl_text_mode_set (TINYGL_TEXT_MODE_SCROLL);
 }
 
 
 /**
- * A task that displays everything on the LED mat.
+ * Advances the game by one tick. The navswitch is only polled on the
+ * ticks where the game reads it.
  */
-static void display_task (__unused__ void *data)
+static void game_tick (void)
 {
-    tinygl_update();
-}
+    Game_Inputs inputs = {0};
 
+    rx_ring_fill (&game_data.rx_ring);
 
-/**
- * Initializes the gun cooldown task.
- */
-static void gun_cooldown_task_init (void)
-{
-    game_data.cooldown_count = 0;
+    if (game_due_tasks (&game_data) & GAME_TASK_INPUT) {
+        inputs.nav_events = navswitch_read_events ();
+
+        if (inputs.nav_events & (NAV_NORTH | NAV_SOUTH)) {
+            LATENCY_PRESS();
+        }
+    }
+
+    game_step (&game_data, &inputs, 1);
 }
 
 
 /**
- * A task that keeps track of the ship's gun cooldown counter
- * and whether or not it is ready to fire again
+ * Runs a game tick every GAME_TICK_PERIOD and sleeps in between. Deadlines
+ * are kept to the timer rather than to when a tick finished, so a late
+ * tick does not push back the ones after it.
  */
-static void gun_cooldown_task (__unused__ void *data)
+static void game_run (void)
 {
-    update_ready(&game_data);
+    timer_tick_t when = timer_get ();
+
+    while (idle_until (when)) {
+        game_tick ();
+        when += GAME_TICK_PERIOD;
+    }
 }
 
 
@@ -165,9 +127,10 @@ void setup_environment(void)
     pio_config_set (LED1_PIO, PIO_OUTPUT_LOW);
     navswitch_task_init ();
     display_task_init ();
-    bullet_move_task_init ();
     ir_uart_init ();
-    gun_cooldown_task_init ();
+    idle_init ();
+    PROFILE_INIT(GAME_TICK_RATE);
+    LATENCY_INIT(GAME_TICK_RATE);
 }
 
 
@@ -178,16 +141,13 @@ int main (void)
 {
     setup_environment();
     setup_game(&game_data);
+    rx_ring_attach(&game_data.rx_ring);
+#ifdef REPLAY
+    if (replay_init(&replay_log)) {
+        game_data.replay = &replay_log;
+    }
+#endif
     game_data.state = STATE_PLAYING;
 
-    task_t tasks[] = {
-        {.func = display_task, .period = TASK_RATE / DISPLAY_RATE},
-        {.func = check_incoming_signal_task, .period = TASK_RATE / CHECK_RATE},
-        {.func = navswitch_task, .period = TASK_RATE / INPUT_RATE},
-        {.func = bullet_move_task, .period = TASK_RATE / BULLET_MOVE_RATE},
-        {.func = gun_cooldown_task, .period = TASK_RATE / COOLDOWN_RATE},
-    };
-
-    task_schedule (tasks, ARRAY_SIZE (tasks));
+    game_run();
 }
-
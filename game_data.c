@@ -9,52 +9,32 @@
 #include "system.h"
 #include "tinygl.h"
 #include "game_data.h"
-#include <string.h>
-#include <stdio.h>
-
-
-#define START_POS {4,3}
-#define NUM_COLUMNS 7
+#include "game_sim.h"
+#include "geometry.h"
 
 
 /**
- * Called to setup a fresh game.
+ * Called to setup a fresh game. A clock sync is queued so that the other
+ * funkit, if it is already running, brings its clock in step with ours.
  * @param game_data - The game data that is to be updated with the new start
  */
 void setup_game (Game_Data* game_data)
 {
-    tinygl_point_t start_pos = START_POS;
-    game_data->ship.ship_pos = start_pos;
-    tinygl_point_t loaded_bullet_pos = {game_data->ship.ship_pos.x-1, game_data->ship.ship_pos.y};
-    game_data->ship.loaded_bullet_pos = loaded_bullet_pos;
+    ship_init(&game_data->ship, START_Y);
     game_data->ready = READY;
-    game_data->ship.aim = DIRECT;
+    game_data->cooldown_count = 0;
+    bullet_pool_init(&game_data->bullets);
+    packet_tx_init(&game_data->tx);
+    packet_rx_init(&game_data->rx);
+    rx_ring_init(&game_data->rx_ring);
+    game_data->tick = 0;
     game_data->own_score = 0;
     game_data->enemy_score = 0;
+    score_banner_init(&game_data->score_banner);
     game_data->state = STATE_PLAYING;
-    show_ship(&game_data->ship, game_data->ready);
-}
-
-
-/**
- * Returns the x position of the ship
- * @param game_data - The game data with ship info
- * @return The x position of the ship as an int
- */
-uint8_t get_ship_x (Game_Data game_data)
-{
-    return game_data.ship.ship_pos.x;
-}
-
-
-/**
- * Returns the y position of the ship
- * @param game_data - The game data with ship info
- * @return The y position of the ship as an int
- */
-uint8_t get_ship_y (Game_Data game_data)
-{
-    return game_data.ship.ship_pos.y;
+    framebuffer_init(&game_data->fb);
+    show_ship(&game_data->fb, &game_data->ship, game_data->ready);
+    packet_queue(&game_data->tx, CLOCK_SYNC);
 }
 
 
@@ -69,7 +49,7 @@ void update_ready (Game_Data* game_data)
         if (game_data->cooldown_count == SHOOT_COOLDOWN) {
             game_data->cooldown_count = 0;
             game_data->ready = READY;
-            show_ship(&game_data->ship, READY);
+            show_ship(&game_data->fb, &game_data->ship, READY);
 
         } else {
             game_data->cooldown_count = game_data->cooldown_count + 1;
@@ -79,82 +59,115 @@ void update_ready (Game_Data* game_data)
 
 
 /**
- * Checks for incoming bullets. Returns a character indicating the column
- * and the direction the bullet is traveling.
- */
-char check_incoming_signal (void)
-{
-    char received_sig = '\0';
-
-    if (ir_uart_read_ready_p()) {
-        received_sig = ir_uart_getc();
-    }
-
-    return received_sig;
-}
-
-
-/**
- * Processes the received signal.
+ * Acts on one event from a received packet. Round starts and clock syncs
+ * bring our clock in step with the sender's, and bullets are placed where
+ * they would be had they arrived on the tick they were sent.
  * @param game_data - The game data with the scores and bullet data
- * @param received_sig - The received character
+ * @param event - The event byte
  */
-void process_signal (Game_Data* game_data, char received_sig)
+static void process_event (Game_Data* game_data, uint8_t event)
 {
-    /* If the received signal is that the enemy has been hit*/
-    if (received_sig == BEEN_HIT) {
-        hide_ship(&game_data->ship);
-        game_data->own_score++;
-        show_score_screen(*game_data);
-        game_data->state = STATE_SCORE;
+    /* If the received signal is how many times the enemy has been hit. The
+     * count is sent again every HITS_PERIOD, so a lost hit is only late,
+     * and the latest count is taken as right, so a corrupted one that got
+     * past the CRC is undone by the next. */
+    if ((event & ~PACKET_HITS_MASK) == PACKET_EVENT_HITS) {
+        uint8_t change = (event - game_data->own_score) & PACKET_HITS_MASK;
+        uint8_t undo = (PACKET_HITS_MASK + 1) - change;
+
+        if (change > PACKET_HITS_MASK / 2) {
+            if (undo <= game_data->own_score) {
+                game_data->own_score -= undo;
+            }
+
+        } else if (change != 0) {
+            hide_ship(&game_data->fb, &game_data->ship);
+            framebuffer_flush(&game_data->fb);
+            game_data->own_score += change;
+            show_score_screen(game_data);
+            game_data->state = STATE_SCORE;
+        }
     }
 
     /* If the received signal is to start a new round */
-    if (received_sig == START_ROUND) {
+    if (event == START_ROUND || event == CLOCK_SYNC) {
+        game_clock_sync(game_data, game_data->rx.stamp);
+    }
+
+    if (event == START_ROUND) {
         game_data->state = STATE_PLAYING;
-        tinygl_clear();
-        show_ship(&game_data->ship, game_data->ready);
+        framebuffer_clear(&game_data->fb);
+        show_ship(&game_data->fb, &game_data->ship, game_data->ready);
         pio_output_low(LED1_PIO);
     }
 
     /* If the received signal is a valid bullet direction */
-    if (received_sig >= COL1 && received_sig <= (COL7 + DIR_RIGHT)) {
-        char direction = (received_sig - COL1) / 10;
-        char column = ((received_sig - COL1) - (10 * direction));
-        column = (-1) * (column - (NUM_COLUMNS - 1)); // inverses the columns so that bullets across the funkits line up
+    if (event & PACKET_EVENT_BULLET) {
+        char direction = (event >> 4) & 0x03;
+        char column = event & PACKET_COLUMN_MASK;
+
+        if (column >= NUM_COLUMNS || direction > DIR_RIGHT) {
+            return;
+        }
+
+        column = (NUM_COLUMNS - 1) - column; // inverses the columns so that bullets across the funkits line up
 
         boing_dir_t bul_dir = DIR_E;
         switch (direction) {
-            case 0:
+            case DIR_STRAIGHT:
                 bul_dir = DIR_E;
                 break;
-            case 1:
+            case DIR_LEFT:
                 bul_dir = DIR_SE;
                 break;
-            case 2:
+            case DIR_RIGHT:
                 bul_dir = DIR_NE;
                 break;
         }
 
-        create_bullet(0, column, bul_dir, game_data->bullets, &game_data->bullet_index);
+        uint8_t missed = game_clock_missed_steps(game_data, game_data->rx.stamp);
+
+        if (create_late_bullet(0, column, bul_dir, missed, ship_pos(&game_data->ship),
+                               &game_data->bullets, &game_data->fb) == BULLET_HIT) {
+            own_ship_hit(game_data);
+        }
+    }
+}
+
+
+/**
+ * Processes a received byte. Once it completes a valid packet each event
+ * in the packet is acted on.
+ * @param game_data - The game data with the scores and bullet data
+ * @param received_sig - The received byte
+ */
+void process_signal (Game_Data* game_data, uint8_t received_sig)
+{
+    uint8_t count = packet_rx_byte(&game_data->rx, received_sig);
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        process_event(game_data, game_data->rx.events[i]);
     }
 }
 
 
 /**
- * Shoots a bullet based on the current ship position and aim position
+ * Shoots a bullet based on the current ship position and aim position.
+ * The ship stays ready to fire if the bullet pool is full.
  * @param game_data - The game data with the ship information
  */
 void shoot_bullet (Game_Data* game_data)
 {
     boing_dir_t direction;
-    uint8_t bullet_y = get_ship_y(*game_data);
+    uint8_t bullet_x = get_ship_x(game_data) - 1;
+    uint8_t bullet_y = get_ship_y(game_data);
 
-    if (game_data->ship.aim == RIGHT) {
+    if (ship_aim(&game_data->ship) == RIGHT) {
         direction = DIR_NW;
         bullet_y++;
 
-    } else if (game_data->ship.aim == LEFT) {
+    } else if (ship_aim(&game_data->ship) == LEFT) {
         direction = DIR_SW;
         bullet_y--;
 
@@ -162,31 +175,20 @@ void shoot_bullet (Game_Data* game_data)
         direction = DIR_W;
     }
 
-    create_bullet(get_ship_x(*game_data) - 1, bullet_y, direction, game_data->bullets, &game_data->bullet_index);
-    game_data->ready = NOT_READY;
+    if (create_bullet(bullet_x, bullet_y, direction, &game_data->bullets, &game_data->fb) == BULLET_OK) {
+        game_data->ready = NOT_READY;
+    }
 }
 
 
 /**
  * Shows the score screen with both players' scores in the format
- * "Score own | enemy"
- * @param game_data - The game data with the scores
+ * "Score own|enemy". The message step scrolls it from there.
+ * @param game_data - A pointer to the game data with the scores
  */
-void show_score_screen (Game_Data game_data)
+void show_score_screen (Game_Data* game_data)
 {
-    char score_string[20];
-    char own_score[4];
-    char enemy_score[4];
-
-    strncpy(score_string, "Score ", 8);
-
-    sprintf(own_score, "%d", game_data.own_score);
-    sprintf(enemy_score, "|%d", game_data.enemy_score);
-
-    strncat(score_string, own_score, 10);
-    strncat(score_string, enemy_score, 10);
-
-    tinygl_text(score_string);
+    score_banner_show(&game_data->score_banner, game_data->own_score, game_data->enemy_score, &game_data->fb);
 }
 
 /**
@@ -196,11 +198,22 @@ void show_score_screen (Game_Data game_data)
  */
 void own_ship_hit(Game_Data* game_data)
 {
-        hide_ship(&game_data->ship);
+        hide_ship(&game_data->fb, &game_data->ship);
+        framebuffer_flush(&game_data->fb);
         game_data->enemy_score++;
         game_data->state = STATE_SCORE;
-        show_score_screen(*game_data);
+        show_score_screen(game_data);
         pio_output_high (LED1_PIO);
-        ir_uart_putc(BEEN_HIT);
+        send_hits(game_data);
+}
+
+
+/**
+ * Sends how many times own ship has been hit.
+ * @param game_data - The game data with the scores
+ */
+void send_hits (Game_Data* game_data)
+{
+    packet_queue(&game_data->tx, PACKET_EVENT_HITS | (game_data->enemy_score & PACKET_HITS_MASK));
 }
 
@@ -12,12 +12,25 @@
 
 #include "system.h"
 #include "ir_uart.h"
+#include "framebuffer.h"
 #include "ship.h"
 #include "bullet.h"
+#include "packet.h"
+#include "rx_ring.h"
+#include "replay.h"
+#include "score.h"
 #include "pio.h"
 
 
+#ifndef SHOOT_COOLDOWN
 #define SHOOT_COOLDOWN 2 // cooldown seconds = SHOOT_COUNTDOWN / COOLDOWN_RATE
+#endif
+
+
+/* Game_Data takes 193 of the funkit's 1 KB of SRAM. A change that needs
+ * more raises the budget itself and says what the bytes are for. Host
+ * builds have wider pointers and padding and are not held to it. */
+#define GAME_DATA_BUDGET 200 // bytes of SRAM on the funkit
 
 
 typedef struct game_data_s Game_Data;
@@ -29,23 +42,34 @@ typedef enum game_state {STATE_PLAYING, STATE_SCORE} state_t;
 typedef enum ship_ready {NOT_READY, READY} ready_t;
 
 
-typedef enum hit_type {ENEMY_HIT = '?', BEEN_HIT = '!', START_ROUND = '?'} hit_t;
+typedef enum hit_type {START_ROUND = PACKET_EVENT_CONTROL | 2, CLOCK_SYNC = PACKET_EVENT_CONTROL | 3} hit_t;
 
 
 struct game_data_s
 {
     Ship ship;
     uint8_t cooldown_count; // cooldown counter to shoot
-    Bullet bullets[MAX_BULLET_COUNT];
-    uint8_t bullet_index;
+    Bullet_Pool bullets;
+    Packet_Tx tx;
+    Packet_Rx rx;
+    Rx_Ring rx_ring; // received IR bytes waiting to be processed
+    Framebuffer fb;
     uint8_t ready; // ready to shoot
     uint8_t own_score;
     uint8_t enemy_score;
+    Score_Banner score_banner; // the banner shown by show_score_screen
     state_t state;
+    uint32_t tick; // game ticks since setup, see game_sim.h
+    Replay_Log* replay; // log of the inputs, NULL when not recording
 
 };
 
 
+#ifdef __AVR__
+_Static_assert (sizeof (Game_Data) <= GAME_DATA_BUDGET, "Game_Data is over its SRAM budget");
+#endif
+
+
 /**
  * Called to setup a fresh game.
  * @param game_data - A pointer to the game data that is to be updated with the new start
@@ -55,18 +79,24 @@ void setup_game(Game_Data* game_data);
 
 /**
  * Returns the x position of the ship
- * @param game_data - The game data with ship info
+ * @param game_data - A pointer to the game data with ship info
  * @return The x position of the ship as an int
  */
-uint8_t get_ship_x (Game_Data game_data);
+static inline uint8_t get_ship_x (const Game_Data* game_data)
+{
+    return ship_pos (&game_data->ship).x;
+}
 
 
 /**
  * Returns the y position of the ship
- * @param game_data - The game data with ship info
+ * @param game_data - A pointer to the game data with ship info
  * @return The y position of the ship as an int
  */
-uint8_t get_ship_y (Game_Data game_data);
+static inline uint8_t get_ship_y (const Game_Data* game_data)
+{
+    return ship_y (&game_data->ship);
+}
 
 
 /**
@@ -77,22 +107,17 @@ void update_ready(Game_Data* game_data);
 
 
 /**
- * Checks for incoming bullets. Returns a character indicating the column
- * and the direction the bullet is traveling.
- */
-char check_incoming_signal (void);
-
-
-/**
- * Processes the received signal.
+ * Processes a received byte. Once it completes a valid packet each event
+ * in the packet is acted on.
  * @param game_data - A pointer to the game data with the scores and bullet data
- * @param received_sig - The received character
+ * @param received_sig - The received byte
  */
-void process_signal(Game_Data* game_data, char received_sig);
+void process_signal(Game_Data* game_data, uint8_t received_sig);
 
 
 /**
- * Shoots a bullet based on the current ship position and aim position
+ * Shoots a bullet based on the current ship position and aim position.
+ * The ship stays ready to fire if the bullet pool is full.
  * @param game_data - A pointer to he game data with the ship information
  */
 void shoot_bullet (Game_Data* game_data);
@@ -100,10 +125,10 @@ void shoot_bullet (Game_Data* game_data);
 
 /**
  * Shows the score screen with both players' scores in the format
- * "Score own | enemy"
- * @param game_data - The game data with the scores
+ * "Score own|enemy". The message step scrolls it from there.
+ * @param game_data - A pointer to the game data with the scores
  */
-void show_score_screen(Game_Data game_data);
+void show_score_screen(Game_Data* game_data);
 
 
 /**
@@ -114,4 +139,11 @@ void show_score_screen(Game_Data game_data);
 void own_ship_hit(Game_Data* game_data);
 
 
+/**
+ * Sends how many times own ship has been hit.
+ * @param game_data - The game data with the scores
+ */
+void send_hits (Game_Data* game_data);
+
+
 #endif
@@ -0,0 +1,290 @@
+/** @file game_sim.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief The deterministic simulation core of the game. Each tick runs the
+ *  steps that are due in the same order the tasks were scheduled in.
+ */
+
+
+#include "system.h"
+#include "tinygl.h"
+#include "game_sim.h"
+#include "profile.h"
+#include "latency.h"
+
+
+/**
+ * Moves all bullets that have been shot and checks whether any of them
+ * has collided with the ship.
+ * @param game_data - A pointer to the game data
+ */
+static void bullet_move_step (Game_Data* game_data)
+{
+    update_bullets(&game_data->bullets, &game_data->tx, &game_data->fb);
+
+    uint8_t collided = collision_check(ship_pos(&game_data->ship), &game_data->bullets);
+
+    if (collided == COLLISION) {
+        own_ship_hit(game_data);
+    }
+}
+
+
+/**
+ * Processes every received IR byte waiting in the ring, logging them in
+ * batches if the game is being recorded.
+ * @param game_data - A pointer to the game data
+ */
+static void signal_step (Game_Data* game_data)
+{
+    uint8_t bytes[REPLAY_RX_MAX];
+    uint8_t count = 0;
+
+    while (!rx_ring_empty (&game_data->rx_ring)) {
+        bytes[count] = rx_ring_pop (&game_data->rx_ring);
+        process_signal (game_data, bytes[count++]);
+
+        if (count == REPLAY_RX_MAX || rx_ring_empty (&game_data->rx_ring)) {
+            if (game_data->replay) {
+                replay_record_rx (game_data->replay, bytes, count);
+            }
+            count = 0;
+        }
+    }
+}
+
+
+/**
+ * Acts on navswitch input. If the current state is playing, then the
+ * navswitch controls the ship. If the current state is score screen, then
+ * the navswitch controls the starting of the next round, and in profiling,
+ * latency and replay builds west dumps the profile counters, the latency
+ * histogram and the replay log.
+ * @param game_data - A pointer to the game data
+ * @param nav_events - The nav_event_t flags pushed since the last step
+ */
+static void input_step (Game_Data* game_data, uint8_t nav_events)
+{
+    if (nav_events && game_data->replay) {
+        replay_record_nav (game_data->replay, nav_events);
+    }
+
+    if (game_data->state == STATE_PLAYING) {
+        if (nav_events & NAV_NORTH) {
+            ship_move_right (&game_data->fb, &game_data->ship, game_data->ready);
+        }
+
+        if (nav_events & NAV_SOUTH) {
+            ship_move_left (&game_data->fb, &game_data->ship, game_data->ready);
+        }
+
+        if (nav_events & NAV_EAST) {
+            ship_aim_right (&game_data->fb, &game_data->ship, game_data->ready);
+        }
+
+        if (nav_events & NAV_WEST) {
+            ship_aim_left (&game_data->fb, &game_data->ship, game_data->ready);
+        }
+
+        if (nav_events & NAV_PUSH) {
+            if (game_data->ready == READY) {
+                shoot_bullet(game_data);
+            }
+        }
+
+    } else if (game_data->state == STATE_SCORE) {
+        if (nav_events & NAV_WEST) {
+            PROFILE_DUMP();
+            LATENCY_DUMP();
+            REPLAY_DUMP(game_data->replay);
+        }
+
+        if (nav_events & NAV_PUSH) {
+            game_data->state = STATE_PLAYING;
+            framebuffer_clear(&game_data->fb);
+            show_ship(&game_data->fb, &game_data->ship, game_data->ready);
+            pio_output_low(LED1_PIO);
+            packet_queue(&game_data->tx, START_ROUND);
+        }
+    }
+}
+
+
+/**
+ * Returns which steps will run on the next tick.
+ * @param game_data - A pointer to the game data
+ * @return The game_task_t flags due on the next tick
+ */
+uint8_t game_due_tasks (const Game_Data* game_data)
+{
+    uint32_t tick = game_data->tick;
+    uint8_t due = GAME_TASK_DISPLAY;
+
+    if (!rx_ring_empty (&game_data->rx_ring)) {
+        due |= GAME_TASK_SIGNAL;
+    }
+
+    if (tick % INPUT_PERIOD == 0) {
+        due |= GAME_TASK_INPUT;
+    }
+
+    if (tick % BULLET_PERIOD == 0) {
+        due |= GAME_TASK_BULLET;
+    }
+
+    if (tick % COOLDOWN_PERIOD == 0) {
+        due |= GAME_TASK_COOLDOWN;
+    }
+
+    if (tick % MESSAGE_PERIOD == 0) {
+        due |= GAME_TASK_MESSAGE;
+    }
+
+    if (tick % HITS_PERIOD == 0) {
+        due |= GAME_TASK_HITS;
+    }
+
+    return due;
+}
+
+
+/**
+ * Returns the stamp for frames sent this tick.
+ * @param game_data - A pointer to the game data
+ * @return The tick modulo CLOCK_STAMP_RANGE
+ */
+uint8_t game_clock_stamp (const Game_Data* game_data)
+{
+    return game_data->tick % CLOCK_STAMP_RANGE;
+}
+
+
+/**
+ * Moves the game clock by the smallest amount that brings it in step with
+ * the sender of a sync frame, allowing CLOCK_SYNC_DELAY for the frame to
+ * arrive.
+ * @param game_data - A pointer to the game data
+ * @param stamp - The stamp of the sync frame
+ */
+void game_clock_sync (Game_Data* game_data, uint8_t stamp)
+{
+    uint16_t target = (stamp + CLOCK_SYNC_DELAY) % CLOCK_STAMP_RANGE;
+    int16_t shift = (target + CLOCK_STAMP_RANGE - game_clock_stamp (game_data)) % CLOCK_STAMP_RANGE;
+
+    if (shift >= CLOCK_STAMP_RANGE / 2) {
+        shift -= CLOCK_STAMP_RANGE;
+    }
+
+    /* Go forward instead of before tick 0. */
+    if (shift < 0 && game_data->tick < (uint16_t) -shift) {
+        shift += CLOCK_STAMP_RANGE;
+    }
+
+    game_data->tick += shift;
+}
+
+
+/**
+ * Returns how many bullet steps have run since the sender's tick in a
+ * stamp. A bullet sent at that tick has missed these steps.
+ * @param game_data - A pointer to the game data
+ * @param stamp - The stamp of a received frame
+ * @return The number of bullet steps run since the stamp
+ */
+uint8_t game_clock_missed_steps (const Game_Data* game_data, uint8_t stamp)
+{
+    uint32_t tick = game_data->tick;
+    uint8_t age = (game_clock_stamp (game_data) + CLOCK_STAMP_RANGE - stamp) % CLOCK_STAMP_RANGE;
+
+    if (age == 0 || tick < age) {
+        return 0;
+    }
+
+    /* This tick's bullet step, if any, has not run yet. */
+    return (tick - 1) / BULLET_PERIOD - (tick - age) / BULLET_PERIOD;
+}
+
+
+/**
+ * Advances the game by a number of ticks. Each tick runs the steps that
+ * are due in a fixed order: display, signal, input, bullet, cooldown,
+ * message and hits. The navswitch presses are consumed by the first input step
+ * that falls inside the ticks, and the signal step takes the received IR
+ * bytes from game_data->rx_ring. Packet events queued during a tick are
+ * sent at the end of it.
+ * @param game_data - A pointer to the game data to advance
+ * @param inputs - A pointer to the navswitch presses
+ * @param dt_ticks - The number of ticks to advance
+ */
+void game_step (Game_Data* game_data, const Game_Inputs* inputs, uint16_t dt_ticks)
+{
+    Game_Inputs pending = *inputs;
+
+    while (dt_ticks > 0) {
+        PROFILE_START(PROFILE_TICK);
+        uint8_t due = game_due_tasks (game_data);
+
+        game_data->tx.stamp = game_clock_stamp (game_data);
+
+        if (due & GAME_TASK_DISPLAY) {
+            PROFILE_START(PROFILE_DISPLAY);
+            framebuffer_flush (&game_data->fb);
+            tinygl_update ();
+            LATENCY_REFRESH();
+            PROFILE_STOP(PROFILE_DISPLAY);
+        }
+
+        if (due & GAME_TASK_SIGNAL) {
+            PROFILE_START(PROFILE_SIGNAL);
+            signal_step (game_data);
+            PROFILE_STOP(PROFILE_SIGNAL);
+        }
+
+        if (due & GAME_TASK_INPUT) {
+            PROFILE_START(PROFILE_INPUT);
+            input_step (game_data, pending.nav_events);
+            pending.nav_events = 0;
+            PROFILE_STOP(PROFILE_INPUT);
+        }
+
+        /* The bullet, cooldown and message steps are skipped when they would
+         * have nothing to do. This is checked here rather than in
+         * game_due_tasks since the input and signal steps can fire a bullet
+         * or end a round earlier in the tick. */
+        if ((due & GAME_TASK_BULLET) && game_data->bullets.count > 0) {
+            PROFILE_START(PROFILE_BULLET);
+            bullet_move_step (game_data);
+            PROFILE_STOP(PROFILE_BULLET);
+        }
+
+        if ((due & GAME_TASK_COOLDOWN) && game_data->ready == NOT_READY) {
+            PROFILE_START(PROFILE_COOLDOWN);
+            update_ready (game_data);
+            PROFILE_STOP(PROFILE_COOLDOWN);
+        }
+
+        if ((due & GAME_TASK_MESSAGE) && game_data->state == STATE_SCORE) {
+            PROFILE_START(PROFILE_MESSAGE);
+            score_banner_scroll (&game_data->score_banner, &game_data->fb);
+            PROFILE_STOP(PROFILE_MESSAGE);
+        }
+
+        /* A lost or corrupted hit would leave the boards on different
+         * scores for good, so the count is sent again every HITS_PERIOD. */
+        if (due & GAME_TASK_HITS) {
+            PROFILE_START(PROFILE_HITS);
+            send_hits (game_data);
+            PROFILE_STOP(PROFILE_HITS);
+        }
+
+        packet_flush (&game_data->tx);
+        PROFILE_STOP(PROFILE_TICK);
+
+        if (game_data->replay) {
+            replay_tick (game_data->replay);
+        }
+
+        game_data->tick++;
+        dt_ticks--;
+    }
+}
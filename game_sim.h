@@ -0,0 +1,119 @@
+/** @file game_sim.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief The deterministic simulation core of the game. Advances the
+ *  display, signal, input, bullet, cooldown, message and hits steps in a fixed order one
+ *  tick at a time, so the game can run at real time on the funkit or as
+ *  fast as possible on a host.
+ */
+
+
+#ifndef GAME_SIM_H
+#define GAME_SIM_H
+
+
+#include "system.h"
+#include "game_data.h"
+
+
+#define GAME_TICK_RATE 500 // one tick per display refresh
+#define DISPLAY_RATE 500
+#ifndef INPUT_RATE
+#define INPUT_RATE 100
+#endif
+#ifndef BULLET_MOVE_RATE
+#define BULLET_MOVE_RATE 5
+#endif
+#define COOLDOWN_RATE 3
+#define MESSAGE_RATE 20 // score banner columns scrolled per second
+#define HITS_RATE 2 // times per second the hit count is sent again, a 5 byte frame each way each time
+
+
+#define INPUT_PERIOD (GAME_TICK_RATE / INPUT_RATE)
+#define BULLET_PERIOD (GAME_TICK_RATE / BULLET_MOVE_RATE)
+#define COOLDOWN_PERIOD (GAME_TICK_RATE / COOLDOWN_RATE)
+#define MESSAGE_PERIOD (GAME_TICK_RATE / MESSAGE_RATE)
+#define HITS_PERIOD (GAME_TICK_RATE / HITS_RATE)
+
+
+/* Frames are stamped with the sender's tick modulo CLOCK_STAMP_RANGE. The
+ * range is a whole number of bullet periods, so once the clocks are synced
+ * both funkits move their bullets on the same ticks. */
+#define CLOCK_STAMP_RANGE (2 * BULLET_PERIOD)
+#define CLOCK_SYNC_DELAY 11 // ticks for a sync frame to cross the IR link at 2400 baud
+
+
+_Static_assert (CLOCK_STAMP_RANGE <= 256, "clock stamps must fit in a byte");
+
+
+typedef struct game_inputs_s Game_Inputs;
+
+
+typedef enum nav_event {NAV_NORTH = 1, NAV_EAST = 2, NAV_SOUTH = 4, NAV_WEST = 8, NAV_PUSH = 16} nav_event_t;
+
+
+typedef enum game_task {GAME_TASK_DISPLAY = 1, GAME_TASK_SIGNAL = 2, GAME_TASK_INPUT = 4,
+                        GAME_TASK_BULLET = 8, GAME_TASK_COOLDOWN = 16, GAME_TASK_MESSAGE = 32,
+                        GAME_TASK_HITS = 64} game_task_t;
+
+
+/* Received IR bytes are not an input here, they arrive in game_data->rx_ring
+ * and every waiting byte is processed on the next tick. */
+struct game_inputs_s
+{
+    uint8_t nav_events; // nav_event_t flags pushed since the last input step
+};
+
+
+/**
+ * Returns which steps will run on the next tick. Callers use this to
+ * poll the navswitch only when the game is about to read it.
+ * @param game_data - A pointer to the game data
+ * @return The game_task_t flags due on the next tick
+ */
+uint8_t game_due_tasks (const Game_Data* game_data);
+
+
+/**
+ * Returns the stamp for frames sent this tick.
+ * @param game_data - A pointer to the game data
+ * @return The tick modulo CLOCK_STAMP_RANGE
+ */
+uint8_t game_clock_stamp (const Game_Data* game_data);
+
+
+/**
+ * Moves the game clock by the smallest amount that brings it in step with
+ * the sender of a sync frame, allowing CLOCK_SYNC_DELAY for the frame to
+ * arrive.
+ * @param game_data - A pointer to the game data
+ * @param stamp - The stamp of the sync frame
+ */
+void game_clock_sync (Game_Data* game_data, uint8_t stamp);
+
+
+/**
+ * Returns how many bullet steps have run since the sender's tick in a
+ * stamp. A bullet sent at that tick has missed these steps.
+ * @param game_data - A pointer to the game data
+ * @param stamp - The stamp of a received frame
+ * @return The number of bullet steps run since the stamp
+ */
+uint8_t game_clock_missed_steps (const Game_Data* game_data, uint8_t stamp);
+
+
+/**
+ * Advances the game by a number of ticks. Each tick runs the steps that
+ * are due in a fixed order: display, signal, input, bullet, cooldown,
+ * message and hits. The navswitch presses are consumed by the first input step
+ * that falls inside the ticks, and the signal step takes the received IR
+ * bytes from game_data->rx_ring. Packet events queued during a tick are
+ * sent at the end of it.
+ * @param game_data - A pointer to the game data to advance
+ * @param inputs - A pointer to the navswitch presses
+ * @param dt_ticks - The number of ticks to advance
+ */
+void game_step (Game_Data* game_data, const Game_Inputs* inputs, uint16_t dt_ticks);
+
+
+#endif
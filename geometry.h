@@ -0,0 +1,40 @@
+/** @file geometry.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 13 Nov 19
+ *  @brief The size of the board and the bounds derived from it. The LED
+ *  mat is TINYGL_WIDTH columns (x) by TINYGL_HEIGHT rows (y). Bullets are
+ *  fired from the ship at x = BOT_OF_MATRIX towards x = 0, where they
+ *  cross over to the other funkit in one of NUM_COLUMNS lanes.
+ *
+ *  The funkit is 5x7. A host build can simulate a bigger board, up to
+ *  64x16, and a bigger bullet pool by defining TINYGL_WIDTH, TINYGL_HEIGHT
+ *  and MAX_BULLET_COUNT.
+ */
+
+
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+
+#include "system.h"
+#include "tinygl.h"
+
+
+#define BOT_OF_MATRIX (TINYGL_WIDTH - 1) // the x of the ship's row
+#define NUM_COLUMNS TINYGL_HEIGHT // lanes a bullet can cross over in
+#define MIN_Y 0 // the ship's bounds
+#define MAX_Y (TINYGL_HEIGHT - 1)
+#define START_Y (TINYGL_HEIGHT / 2) // the row the ship starts on
+
+
+#ifndef MAX_BULLET_COUNT
+#define MAX_BULLET_COUNT 10
+#endif
+
+
+_Static_assert (TINYGL_WIDTH >= 2 && TINYGL_WIDTH <= 64, "bullets need a row to fly in and the framebuffer dirty mask has a bit per column, 64 at most");
+_Static_assert (TINYGL_HEIGHT >= 2 && TINYGL_HEIGHT <= 16, "bullets bounce between two rows at least and a lane must fit the 4 bits it is sent in");
+_Static_assert (MAX_BULLET_COUNT >= 1, "the bullet pool needs a slot");
+
+
+#endif
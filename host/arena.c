@@ -0,0 +1,454 @@
+/** @file arena.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 15 Nov 19
+ *  @brief Load tests the game by holding thousands of bot matches in one
+ *  process, each a pair of simulated funkits with their IR linked, and
+ *  stepping them all for a while. Prints the ticks stepped per second,
+ *  the memory each match takes and the spread of the time one match
+ *  takes to step one tick.
+ *
+ *  The matches are split into one even shard per thread and a shard only
+ *  ever runs on its own thread, since both boards of a match have to be
+ *  selected on the thread stepping them. Each shard allocates its own
+ *  matches. A match that ends is started again with a new seed, so the
+ *  load stays steady. With a tick rate, each shard steps all its matches
+ *  once per 1 / rate seconds and sleeps in between, as a server would,
+ *  and counts the frames it could not finish in time. Without one every
+ *  shard steps as fast as it can.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "system.h"
+#include "game_sim.h"
+#include "match.h"
+
+
+#define ARENA_PAIRS 1000
+#define ARENA_SECONDS 2
+#define ARENA_MAX_RUNS 16 // pair and thread counts that can be listed
+#define ARENA_SUB_BITS 2 // histogram buckets per power of two = 1 << ARENA_SUB_BITS
+#define ARENA_HIST_SIZE (64 << ARENA_SUB_BITS)
+
+
+typedef struct shard_s Shard;
+
+
+typedef enum arena_start {ARENA_WAIT, ARENA_GO, ARENA_STOP} arena_start_t;
+
+
+struct shard_s
+{
+    pthread_t thread;
+    uint32_t first; // number of the shard's first match, seeds its matches
+    uint32_t count;
+    uint64_t ticks; // match ticks stepped
+    uint32_t finished; // matches played to the end
+    uint32_t frames;
+    uint32_t late_frames; // frames that ran past the next one's start
+    uint32_t hist[ARENA_HIST_SIZE]; // match tick times in ns
+};
+
+
+static uint32_t tick_rate; // frames per second, 0 to run flat out
+
+
+static uint64_t run_ns;
+
+
+/* The shards set up their matches, count themselves ready and wait for
+ * start_state to leave ARENA_WAIT. The main thread starts the clock once
+ * every shard is ready, or stops them if a shard thread failed to start. */
+static pthread_mutex_t start_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static pthread_cond_t start_cond = PTHREAD_COND_INITIALIZER;
+
+
+static uint16_t shards_ready;
+
+
+static arena_start_t start_state;
+
+
+/**
+ * Returns a monotonic time in ns.
+ * @return The time in ns
+ */
+static uint64_t arena_now (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+
+/**
+ * Sleeps until a time.
+ * @param when - The time in ns, as arena_now gives it
+ */
+static void arena_sleep_until (uint64_t when)
+{
+    struct timespec until = {when / 1000000000u, when % 1000000000u};
+
+    while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR) {
+        continue;
+    }
+}
+
+
+/**
+ * Returns the histogram bucket of a time. Each power of two is split
+ * into 1 << ARENA_SUB_BITS buckets, so a bucket is within 25% of its
+ * times.
+ * @param ns - The time
+ * @return The bucket
+ */
+static uint16_t arena_bucket (uint64_t ns)
+{
+    uint8_t top;
+
+    if (ns < (1 << ARENA_SUB_BITS)) {
+        return ns;
+    }
+
+    top = 63 - __builtin_clzll (ns);
+    return (top - ARENA_SUB_BITS + 1) << ARENA_SUB_BITS | ((ns >> (top - ARENA_SUB_BITS)) & ((1 << ARENA_SUB_BITS) - 1));
+}
+
+
+/**
+ * Returns the smallest time in a histogram bucket.
+ * @param bucket - The bucket
+ * @return The time in ns
+ */
+static uint64_t arena_bucket_ns (uint16_t bucket)
+{
+    uint16_t top = bucket >> ARENA_SUB_BITS;
+    uint64_t sub = bucket & ((1 << ARENA_SUB_BITS) - 1);
+
+    if (top == 0) {
+        return sub;
+    }
+
+    return ((1 << ARENA_SUB_BITS) | sub) << (top - 1);
+}
+
+
+/**
+ * Returns the time below which a fraction of the times in a histogram
+ * fall.
+ * @param hist - The histogram
+ * @param total - The number of times in it
+ * @param fraction - The fraction, 0 to 1, where 1 gives the longest time
+ * @return The start of the bucket holding that time, in ns
+ */
+static uint64_t arena_percentile (const uint64_t* hist, uint64_t total, double fraction)
+{
+    uint64_t wanted = total * fraction;
+    uint64_t seen = 0;
+    uint16_t i;
+
+    if (wanted >= total) {
+        wanted = total - 1;
+    }
+
+    for (i = 0; i < ARENA_HIST_SIZE; i++) {
+        seen += hist[i];
+        if (seen > wanted) {
+            return arena_bucket_ns (i);
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Starts the match in a slot, pairing the bot policies in turn over the
+ * slots.
+ * @param match - The match
+ * @param slot - The number of the slot
+ * @param round - How many matches the slot has played before
+ */
+static void arena_start_match (Match* match, uint32_t slot, uint32_t round)
+{
+    match_init (match, &bot_policies[slot % bot_num_policies],
+                &bot_policies[slot / bot_num_policies % bot_num_policies], slot ^ round << 20);
+}
+
+
+/**
+ * Counts a shard as ready and waits for the main thread to start or stop
+ * the run.
+ * @return 1 to run, 0 to stop
+ */
+static uint8_t arena_wait_start (void)
+{
+    uint8_t go;
+
+    pthread_mutex_lock (&start_lock);
+    shards_ready++;
+    pthread_cond_broadcast (&start_cond);
+    while (start_state == ARENA_WAIT) {
+        pthread_cond_wait (&start_cond, &start_lock);
+    }
+    go = start_state == ARENA_GO;
+    pthread_mutex_unlock (&start_lock);
+
+    return go;
+}
+
+
+/**
+ * Steps a shard's matches until the run time is up.
+ * @param arg - The shard
+ * @return NULL
+ */
+static void* shard_run (void* arg)
+{
+    Shard* shard = arg;
+    Match* matches = calloc (shard->count, sizeof (*matches));
+    uint64_t start;
+    uint64_t now;
+    uint32_t i;
+
+    if (matches == NULL && shard->count > 0) {
+        fprintf (stderr, "arena: out of memory\n");
+        exit (1);
+    }
+
+    for (i = 0; i < shard->count; i++) {
+        arena_start_match (&matches[i], shard->first + i, 0);
+    }
+
+    if (!arena_wait_start ()) {
+        free (matches);
+        return NULL;
+    }
+
+    /* With fewer matches than threads some shards are empty, and would
+     * never see the clock move. */
+    if (shard->count == 0) {
+        free (matches);
+        return NULL;
+    }
+
+    start = arena_now ();
+    now = start;
+
+    while (now - start < run_ns) {
+        for (i = 0; i < shard->count; i++) {
+            uint64_t before = arena_now ();
+
+            match_tick (&matches[i]);
+            now = arena_now ();
+            shard->hist[arena_bucket (now - before)]++;
+
+            if (match_over (&matches[i])) {
+                shard->finished++;
+                arena_start_match (&matches[i], shard->first + i, shard->finished);
+            }
+        }
+
+        shard->ticks += shard->count;
+        shard->frames++;
+
+        if (tick_rate) {
+            uint64_t next = start + shard->frames * 1000000000ull / tick_rate;
+
+            if (now > next) {
+                shard->late_frames++;
+            } else {
+                arena_sleep_until (next);
+                now = next;
+            }
+        }
+    }
+
+    free (matches);
+    return NULL;
+}
+
+
+/**
+ * Steps a number of matches on a number of threads and prints one line
+ * of results.
+ * @param pairs - The number of matches
+ * @param threads - The number of threads
+ */
+static void arena_run (uint32_t pairs, uint16_t threads)
+{
+    static uint64_t hist[ARENA_HIST_SIZE];
+    Shard* shards = calloc (threads, sizeof (*shards));
+    uint64_t ticks = 0;
+    uint32_t finished = 0;
+    uint32_t frames = 0;
+    uint32_t late_frames = 0;
+    uint64_t start;
+    double elapsed;
+    uint16_t started;
+    uint16_t i;
+    uint16_t j;
+
+    if (shards == NULL) {
+        fprintf (stderr, "arena: out of memory\n");
+        exit (1);
+    }
+
+    memset (hist, 0, sizeof (hist));
+    shards_ready = 0;
+    start_state = ARENA_WAIT;
+
+    for (i = 0; i < threads; i++) {
+        shards[i].first = (uint64_t) pairs * i / threads;
+        shards[i].count = (uint64_t) pairs * (i + 1) / threads - shards[i].first;
+        if (pthread_create (&shards[i].thread, NULL, shard_run, &shards[i]) != 0) {
+            break;
+        }
+    }
+    started = i;
+
+    pthread_mutex_lock (&start_lock);
+    if (started < threads) {
+        start_state = ARENA_STOP;
+    } else {
+        while (shards_ready < started) {
+            pthread_cond_wait (&start_cond, &start_lock);
+        }
+        start_state = ARENA_GO;
+    }
+    pthread_cond_broadcast (&start_cond);
+    pthread_mutex_unlock (&start_lock);
+
+    start = arena_now ();
+
+    for (i = 0; i < started; i++) {
+        pthread_join (shards[i].thread, NULL);
+    }
+
+    elapsed = (arena_now () - start) / 1e9;
+
+    if (started < threads) {
+        fprintf (stderr, "arena: cannot start thread %u\n", started);
+        free (shards);
+        exit (1);
+    }
+
+    for (i = 0; i < threads; i++) {
+        ticks += shards[i].ticks;
+        finished += shards[i].finished;
+        frames += shards[i].frames;
+        late_frames += shards[i].late_frames;
+
+        for (j = 0; j < ARENA_HIST_SIZE; j++) {
+            hist[j] += shards[i].hist[j];
+        }
+    }
+
+    printf ("%7lu %7u %11.0f %11.0f %7.0f %7lu %7lu %7lu %7lu %7lu %6.1f%%\n",
+            (unsigned long) pairs, threads, ticks / elapsed, ticks / elapsed / threads,
+            finished / elapsed,
+            (unsigned long) arena_percentile (hist, ticks, 0.5),
+            (unsigned long) arena_percentile (hist, ticks, 0.99),
+            (unsigned long) arena_percentile (hist, ticks, 0.999),
+            (unsigned long) arena_percentile (hist, ticks, 0.9999),
+            (unsigned long) arena_percentile (hist, ticks, 1.0),
+            frames ? 100.0 * late_frames / frames : 0.0);
+
+    free (shards);
+}
+
+
+/**
+ * Reads a comma separated list of counts.
+ * @param arg - The list
+ * @param counts - Filled with the counts
+ * @return The number of counts read, 0 if the list is not valid
+ */
+static uint8_t arena_parse_counts (const char* arg, uint32_t* counts)
+{
+    uint8_t num = 0;
+    char* end;
+
+    do {
+        if (num == ARENA_MAX_RUNS) {
+            return 0;
+        }
+
+        counts[num] = strtoul (arg, &end, 0);
+        if (end == arg || counts[num] == 0) {
+            return 0;
+        }
+        num++;
+        arg = end + 1;
+    } while (*end == ',');
+
+    return *end == '\0' ? num : 0;
+}
+
+
+/**
+ * Runs the arena. The arguments are optional: the number of matches and
+ * of threads, each a single count or a comma separated list to run every
+ * combination of, then the tick rate (0 for as fast as possible) and the
+ * seconds to run each combination for.
+ */
+int main (int argc, char** argv)
+{
+    uint32_t pairs[ARENA_MAX_RUNS] = {ARENA_PAIRS};
+    uint32_t threads[ARENA_MAX_RUNS];
+    uint8_t num_pairs = 1;
+    uint8_t num_threads = 1;
+    double seconds = ARENA_SECONDS;
+    uint8_t i;
+    uint8_t j;
+
+    threads[0] = sysconf (_SC_NPROCESSORS_ONLN);
+
+    if (argc > 1) {
+        num_pairs = arena_parse_counts (argv[1], pairs);
+    }
+    if (argc > 2) {
+        num_threads = arena_parse_counts (argv[2], threads);
+    }
+    if (argc > 3) {
+        tick_rate = strtoul (argv[3], NULL, 0);
+    }
+    if (argc > 4) {
+        seconds = atof (argv[4]);
+    }
+
+    if (num_pairs == 0 || num_threads == 0 || seconds <= 0) {
+        fprintf (stderr, "usage: %s [pairs[,pairs...]] [threads[,threads...]] [tick-rate] [seconds]\n", argv[0]);
+        return 1;
+    }
+    run_ns = seconds * 1e9;
+
+    printf ("%u bytes per match (Game_Data %u, Funkit %u), ", (unsigned) sizeof (Match),
+            (unsigned) sizeof (Game_Data), (unsigned) sizeof (Funkit));
+    if (tick_rate) {
+        printf ("%lu ticks/s per match, ", (unsigned long) tick_rate);
+    } else {
+        printf ("as fast as possible, ");
+    }
+    printf ("%.1f s per run\n", seconds);
+
+    printf ("%7s %7s %11s %11s %7s %7s %7s %7s %7s %7s %7s\n", "pairs", "threads", "ticks/s",
+            "per thread", "ends/s", "p50 ns", "p99", "p99.9", "p99.99", "max", "late");
+
+    for (i = 0; i < num_pairs; i++) {
+        for (j = 0; j < num_threads; j++) {
+            arena_run (pairs[i], threads[j]);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,354 @@
+/** @file bench.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 8 Nov 19
+ *  @brief Host micro-benchmarks for the bullet, ship and signal kernels.
+ *
+ *  Each benchmark runs one kernel many times against a worst-case game
+ *  state and prints the mean ns per call. The game never allocates from
+ *  the heap, so instead of allocations the bullet pool use is reported:
+ *  the most slots live after any call and how many bullets the
+ *  pool had to refuse.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "system.h"
+#include "tinygl.h"
+#include "ir_uart.h"
+#include "funkit.h"
+#include "game_data.h"
+
+
+#define BENCH_ITERATIONS 1000000
+#define BENCH_WARMUP 1000
+#define BENCH_BURST_SIZE (PACKET_MAX_EVENTS + 4) // sync, header, stamp, events and crc
+
+
+typedef struct bench_s Bench;
+
+
+struct bench_s
+{
+    const char* name;
+    void (*setup) (Game_Data* game_data);
+    void (*op) (Game_Data* game_data, uint32_t i);
+};
+
+
+static Funkit bench_kit;
+
+
+static Bullet_Pool full_pool; // a pool with every slot live, copied in before each step
+
+
+static uint8_t burst[BENCH_BURST_SIZE]; // one full packet of bullet events
+
+
+static volatile uint8_t bench_sink; // keeps results the compiler could otherwise drop
+
+
+/**
+ * Returns a monotonic time in ns.
+ * @return The time in ns
+ */
+static uint64_t bench_now (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+
+/**
+ * Fills a bullet pool, spreading the bullets over every row and direction.
+ * @param pool - The bullet pool to fill
+ * @param fb - The framebuffer the bullets are drawn to
+ */
+static void fill_pool (Bullet_Pool* pool, Framebuffer* fb)
+{
+    static const boing_dir_t dirs[] = {DIR_W, DIR_NW, DIR_SW};
+    bullet_index_t i;
+
+    for (i = 0; pool->count < MAX_BULLET_COUNT; i++) {
+        create_bullet ((i % (TINYGL_WIDTH - 1)) + 1, i % TINYGL_HEIGHT,
+                       dirs[i % ARRAY_SIZE (dirs)], pool, fb);
+    }
+}
+
+
+/**
+ * Starts a benchmark from a fresh game.
+ * @param game_data - The game data to set up
+ */
+static void setup_empty (Game_Data* game_data)
+{
+    setup_game (game_data);
+}
+
+
+/**
+ * Starts a benchmark with every bullet slot live.
+ * @param game_data - The game data to set up
+ */
+static void setup_full (Game_Data* game_data)
+{
+    setup_game (game_data);
+    fill_pool (&game_data->bullets, &game_data->fb);
+    full_pool = game_data->bullets;
+}
+
+
+/**
+ * Encodes one packet of bullet events in burst.
+ * @param game_data - The game data to send it from
+ */
+static void encode_burst (Game_Data* game_data)
+{
+    uint8_t i;
+
+    packet_tx_init (&game_data->tx); // drop the clock sync from setup_game
+
+    for (i = 0; i < PACKET_MAX_EVENTS; i++) {
+        packet_queue (&game_data->tx, PACKET_EVENT_BULLET | (i % 3) << 4 | (i % NUM_COLUMNS));
+    }
+    packet_flush (&game_data->tx);
+
+    for (i = 0; i < BENCH_BURST_SIZE; i++) {
+        burst[i] = ir_uart_getc ();
+    }
+}
+
+
+/**
+ * Starts a benchmark with every bullet slot live and one packet of
+ * bullet events encoded in burst.
+ * @param game_data - The game data to set up
+ */
+static void setup_burst (Game_Data* game_data)
+{
+    setup_full (game_data);
+    encode_burst (game_data);
+}
+
+
+/**
+ * Starts a benchmark from a fresh game with one packet of bullet events
+ * encoded in burst.
+ * @param game_data - The game data to set up
+ */
+static void setup_burst_empty (Game_Data* game_data)
+{
+    setup_empty (game_data);
+    encode_burst (game_data);
+}
+
+
+/**
+ * Copies the full pool back in. Timed on its own so it can be told apart
+ * from the update_bullets run that needs it.
+ */
+static void op_pool_copy (Game_Data* game_data, __unused__ uint32_t i)
+{
+    game_data->bullets = full_pool;
+}
+
+
+/**
+ * Steps a full pool of bullets once.
+ */
+static void op_update_bullets (Game_Data* game_data, __unused__ uint32_t i)
+{
+    game_data->bullets = full_pool;
+    update_bullets (&game_data->bullets, &game_data->tx, &game_data->fb);
+    game_data->tx.count = 0;
+}
+
+
+/**
+ * Checks a full pool against each ship position in turn.
+ */
+static void op_collision_check (Game_Data* game_data, uint32_t i)
+{
+    tinygl_point_t ship_pos = {BOT_OF_MATRIX, i % TINYGL_HEIGHT};
+
+    bench_sink = collision_check (ship_pos, &game_data->bullets);
+}
+
+
+/**
+ * Fires bullets into the pool, emptying it again each time it fills.
+ */
+static void op_create_bullet (Game_Data* game_data, uint32_t i)
+{
+    if (game_data->bullets.count == MAX_BULLET_COUNT) {
+        bullet_pool_init (&game_data->bullets);
+    }
+    bench_sink = create_bullet (BOT_OF_MATRIX - 1, i % TINYGL_HEIGHT, DIR_W, &game_data->bullets, &game_data->fb);
+}
+
+
+/**
+ * Fires a bullet into a pool that is already full.
+ */
+static void op_create_bullet_full (Game_Data* game_data, uint32_t i)
+{
+    bench_sink = create_bullet (BOT_OF_MATRIX - 1, i % TINYGL_HEIGHT, DIR_W, &game_data->bullets, &game_data->fb);
+}
+
+
+/**
+ * Feeds one byte of a packet of bullet events into a full pool.
+ */
+static void op_process_signal (Game_Data* game_data, uint32_t i)
+{
+    process_signal (game_data, burst[i % BENCH_BURST_SIZE]);
+}
+
+
+/**
+ * Feeds one byte of a packet of bullet events into a pool that is emptied
+ * before each packet, so every bullet in it is added.
+ */
+static void op_process_signal_empty (Game_Data* game_data, uint32_t i)
+{
+    if (i % BENCH_BURST_SIZE == 0) {
+        bullet_pool_init (&game_data->bullets);
+    }
+    process_signal (game_data, burst[i % BENCH_BURST_SIZE]);
+}
+
+
+/**
+ * Moves the ship back and forth across the LED mat.
+ */
+static void op_ship_move (Game_Data* game_data, uint32_t i)
+{
+    if ((i / TINYGL_HEIGHT) & 1) {
+        ship_move_left (&game_data->fb, &game_data->ship, game_data->ready);
+    } else {
+        ship_move_right (&game_data->fb, &game_data->ship, game_data->ready);
+    }
+}
+
+
+/**
+ * Swings the ship's aim from side to side every call.
+ */
+static void op_ship_aim (Game_Data* game_data, uint32_t i)
+{
+    if (i & 1) {
+        ship_aim_left (&game_data->fb, &game_data->ship, game_data->ready);
+    } else {
+        ship_aim_right (&game_data->fb, &game_data->ship, game_data->ready);
+    }
+}
+
+
+static const Bench benches[] = {
+    {"pool_copy", setup_full, op_pool_copy},
+    {"update_bullets", setup_full, op_update_bullets},
+    {"collision_check", setup_full, op_collision_check},
+    {"create_bullet", setup_empty, op_create_bullet},
+    {"create_bullet_full", setup_full, op_create_bullet_full},
+    {"process_signal", setup_burst, op_process_signal},
+    {"process_signal_empty", setup_burst_empty, op_process_signal_empty},
+    {"ship_move", setup_empty, op_ship_move},
+    {"ship_aim", setup_empty, op_ship_aim},
+};
+
+
+/**
+ * Runs one benchmark and prints its result. The pool is checked on a
+ * second, untimed run so that the check does not add to the time.
+ * @param bench - The benchmark
+ * @param iterations - How many timed calls to make
+ */
+static void bench_run (const Bench* bench, uint32_t iterations)
+{
+    static Game_Data game_data;
+    uint32_t refused = 0;
+    uint32_t drawn;
+    uint32_t written;
+    uint16_t overflow;
+    bullet_index_t live = 0; // most bullets live after a call
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t i;
+
+    bench->setup (&game_data);
+
+    for (i = 0; i < BENCH_WARMUP; i++) {
+        bench->op (&game_data, i);
+    }
+
+    start = bench_now ();
+    for (i = 0; i < iterations; i++) {
+        bench->op (&game_data, i);
+    }
+    elapsed = bench_now () - start;
+
+    /* The untimed run flushes after each call, as a display tick would. */
+    bench->setup (&game_data);
+    framebuffer_flush (&game_data.fb);
+    drawn = game_data.fb.draw_count;
+    written = game_data.fb.write_count;
+
+    for (i = 0; i < iterations; i++) {
+        overflow = game_data.bullets.overflow_count;
+        bench->op (&game_data, i);
+        framebuffer_flush (&game_data.fb);
+        refused += (uint16_t) (game_data.bullets.overflow_count - overflow);
+        if (game_data.bullets.count > live) {
+            live = game_data.bullets.count;
+        }
+    }
+
+    drawn = game_data.fb.draw_count - drawn;
+    written = game_data.fb.write_count - written;
+
+    printf ("%-20s %10.2f ns/op  live max %3u/%u  refused %.2f/op  pixels drawn %.2f/op written %.2f/op\n",
+            bench->name, (double) elapsed / iterations, (unsigned) live,
+            MAX_BULLET_COUNT, (double) refused / iterations, (double) drawn / iterations,
+            (double) written / iterations);
+}
+
+
+/**
+ * Runs the benchmarks. The first argument is an optional number of
+ * iterations, and any further arguments pick benchmarks by name.
+ */
+int main (int argc, char** argv)
+{
+    uint32_t iterations = BENCH_ITERATIONS;
+    uint8_t i;
+    int arg;
+
+    if (argc > 1) {
+        iterations = strtoul (argv[1], NULL, 0);
+    }
+    if (iterations == 0) {
+        iterations = BENCH_ITERATIONS;
+    }
+
+    funkit_init (&bench_kit);
+    funkit_select (&bench_kit);
+    tinygl_init (1000);
+
+    for (i = 0; i < ARRAY_SIZE (benches); i++) {
+        if (argc <= 2) {
+            bench_run (&benches[i], iterations);
+            continue;
+        }
+        for (arg = 2; arg < argc; arg++) {
+            if (strcmp (argv[arg], benches[i].name) == 0) {
+                bench_run (&benches[i], iterations);
+            }
+        }
+    }
+
+    return 0;
+}
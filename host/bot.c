@@ -0,0 +1,241 @@
+/** @file bot.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 14 Nov 19
+ *  @brief Scripted players for host matches.
+ */
+
+
+#include <string.h>
+#include "system.h"
+#include "game_sim.h"
+#include "bot.h"
+
+
+#define BOT_LOOKAHEAD 3 // columns in front of the ship a dodger watches
+
+
+/**
+ * Returns the next random number of a bot.
+ * @param bot - A pointer to the bot
+ * @return A random number
+ */
+static uint32_t bot_random (Bot* bot)
+{
+    uint32_t x = bot->rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    bot->rng = x;
+
+    return x;
+}
+
+
+/**
+ * Returns the rows that incoming bullets close to the bottom row will
+ * land on.
+ * @param game_data - The game
+ * @return A mask with bit y set if a bullet will land on row y
+ */
+static uint16_t bot_threats (const Game_Data* game_data)
+{
+    const Bullet_Pool* pool = &game_data->bullets;
+    uint16_t rows = 0;
+    bullet_index_t i;
+
+    for (i = 0; i < pool->count; i++) {
+        bullet_pos_t pos = pool->pos[i];
+        uint8_t state = pool->state[i];
+        uint8_t dir = state & BULLET_DIR_MASK;
+
+        if (dir < DIR_NE || dir > DIR_SE || bullet_pos_x (pos) < BOT_OF_MATRIX - BOT_LOOKAHEAD) {
+            continue; // outgoing, or still far away
+        }
+
+        bullet_advance (&pos, &state, bullet_steps_left (pos, state));
+        rows |= 1 << bullet_pos_y (pos);
+    }
+
+    return rows;
+}
+
+
+/**
+ * Never presses anything, a target for the other policies.
+ */
+static uint8_t decide_idle (__unused__ Bot* bot, __unused__ const Game_Data* game_data)
+{
+    return 0;
+}
+
+
+/**
+ * Stays put and fires straight ahead whenever it can.
+ */
+static uint8_t decide_turret (__unused__ Bot* bot, const Game_Data* game_data)
+{
+    if (ship_aim (&game_data->ship) == LEFT) {
+        return NAV_EAST;
+    }
+
+    if (ship_aim (&game_data->ship) == RIGHT) {
+        return NAV_WEST;
+    }
+
+    return game_data->ready == READY ? NAV_PUSH : 0;
+}
+
+
+/**
+ * Presses a random switch about a quarter of the time.
+ */
+static uint8_t decide_random (Bot* bot, __unused__ const Game_Data* game_data)
+{
+    static const uint8_t presses[] = {NAV_NORTH, NAV_EAST, NAV_SOUTH, NAV_WEST, NAV_PUSH};
+    uint32_t r = bot_random (bot);
+
+    if (r & 3) {
+        return 0;
+    }
+
+    return presses[(r >> 2) % ARRAY_SIZE (presses)];
+}
+
+
+/**
+ * Sweeps from side to side, firing whenever it can and turning at the
+ * edges.
+ */
+static uint8_t decide_sweeper (Bot* bot, const Game_Data* game_data)
+{
+    uint8_t y = ship_y (&game_data->ship);
+
+    if (game_data->ready == READY) {
+        return NAV_PUSH;
+    }
+
+    if (y == MIN_Y) {
+        bot->heading = NAV_SOUTH;
+
+    } else if (y == MAX_Y) {
+        bot->heading = NAV_NORTH;
+    }
+
+    return bot->heading;
+}
+
+
+/**
+ * Moves off any row an incoming bullet is about to land on, and otherwise
+ * fires with a random aim whenever it can.
+ */
+static uint8_t decide_dodger (Bot* bot, const Game_Data* game_data)
+{
+    uint16_t threats = bot_threats (game_data);
+    uint8_t y = ship_y (&game_data->ship);
+
+    if (threats & (1 << y)) {
+        uint8_t up_free = y > MIN_Y && !(threats & (1 << (y - 1)));
+        uint8_t down_free = y < MAX_Y && !(threats & (1 << (y + 1)));
+
+        if (up_free && down_free) {
+            return bot_random (bot) & 1 ? NAV_NORTH : NAV_SOUTH;
+        }
+
+        /* NAV_NORTH moves the ship to the row above, see input_step. */
+        return up_free ? NAV_NORTH : down_free ? NAV_SOUTH : 0;
+    }
+
+    if (game_data->ready == READY) {
+        uint8_t aim = bot_random (bot) % 3;
+
+        if (aim == ship_aim (&game_data->ship)) {
+            return NAV_PUSH;
+        }
+        return aim < ship_aim (&game_data->ship) ? NAV_WEST : NAV_EAST;
+    }
+
+    return 0;
+}
+
+
+const Bot_Policy bot_policies[] = {
+    {"idle", decide_idle},
+    {"turret", decide_turret},
+    {"random", decide_random},
+    {"sweeper", decide_sweeper},
+    {"dodger", decide_dodger},
+};
+
+
+const uint8_t bot_num_policies = ARRAY_SIZE (bot_policies);
+
+
+/**
+ * Finds a policy by name.
+ * @param name - The name of the policy
+ * @return The policy, or NULL if there is none by that name
+ */
+const Bot_Policy* bot_find (const char* name)
+{
+    uint8_t i;
+
+    for (i = 0; i < bot_num_policies; i++) {
+        if (strcmp (bot_policies[i].name, name) == 0) {
+            return &bot_policies[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Starts a bot.
+ * @param bot - A pointer to the bot
+ * @param policy - The policy the bot plays by
+ * @param seed - Seeds the bot's random choices, the same seed plays the same game
+ */
+void bot_init (Bot* bot, const Bot_Policy* policy, uint32_t seed)
+{
+    bot->policy = policy;
+    bot->rng = seed * 2654435761u | 1;
+    bot->wait = 0;
+    bot->heading = NAV_NORTH;
+}
+
+
+/**
+ * Returns the navswitch presses for an input step. On the score screen
+ * every bot pushes to start the next round, unless the other board may
+ * already have started it. Otherwise the bot's policy decides, and after
+ * a press the bot waits BOT_REACTION_STEPS before it presses again, as a
+ * player would.
+ * @param bot - A pointer to the bot
+ * @param game_data - The game the bot is playing
+ * @return The nav_event_t flags pressed
+ */
+uint8_t bot_decide (Bot* bot, const Game_Data* game_data)
+{
+    uint8_t nav_events;
+
+    if (bot->wait > 0) {
+        bot->wait--;
+        return 0;
+    }
+
+    if (game_data->state == STATE_SCORE) {
+        /* Waiting bytes may hold the other board's START_ROUND, which is
+         * processed before the push and would turn it into a shot. */
+        nav_events = rx_ring_empty (&game_data->rx_ring) ? NAV_PUSH : 0;
+    } else {
+        nav_events = bot->policy->decide (bot, game_data);
+    }
+
+    if (nav_events) {
+        bot->wait = BOT_REACTION_STEPS;
+    }
+
+    return nav_events;
+}
@@ -0,0 +1,80 @@
+/** @file bot.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 14 Nov 19
+ *  @brief Scripted players for host matches. A bot is asked for navswitch
+ *  presses on each input step, the same Game_Inputs a player gives the
+ *  game, so its moves go through ship_move_*, ship_aim_* and shoot_bullet
+ *  exactly as a player's would.
+ */
+
+
+#ifndef BOT_H
+#define BOT_H
+
+
+#include "system.h"
+#include "game_data.h"
+
+
+#define BOT_REACTION_STEPS 15 // input steps a bot waits after a press, 150 ms at INPUT_RATE
+
+
+typedef struct bot_s Bot;
+
+
+typedef struct bot_policy_s Bot_Policy;
+
+
+struct bot_policy_s
+{
+    const char* name;
+    uint8_t (*decide) (Bot* bot, const Game_Data* game_data); // returns nav_event_t flags
+};
+
+
+struct bot_s
+{
+    const Bot_Policy* policy;
+    uint32_t rng; // xorshift32 state, never 0
+    uint8_t wait; // input steps until the bot can press again
+    uint8_t heading; // NAV_NORTH or NAV_SOUTH, for bots that sweep
+};
+
+
+extern const Bot_Policy bot_policies[];
+
+
+extern const uint8_t bot_num_policies;
+
+
+/**
+ * Finds a policy by name.
+ * @param name - The name of the policy
+ * @return The policy, or NULL if there is none by that name
+ */
+const Bot_Policy* bot_find (const char* name);
+
+
+/**
+ * Starts a bot.
+ * @param bot - A pointer to the bot
+ * @param policy - The policy the bot plays by
+ * @param seed - Seeds the bot's random choices, the same seed plays the same game
+ */
+void bot_init (Bot* bot, const Bot_Policy* policy, uint32_t seed);
+
+
+/**
+ * Returns the navswitch presses for an input step. On the score screen
+ * every bot pushes to start the next round, unless the other board may
+ * already have started it. Otherwise the bot's policy decides, and after
+ * a press the bot waits BOT_REACTION_STEPS before it presses again, as a
+ * player would.
+ * @param bot - A pointer to the bot
+ * @param game_data - The game the bot is playing
+ * @return The nav_event_t flags pressed
+ */
+uint8_t bot_decide (Bot* bot, const Game_Data* game_data);
+
+
+#endif
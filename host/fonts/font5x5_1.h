@@ -0,0 +1,129 @@
+/** @file font5x5_1.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the 5x5 font. Only the glyphs the game draws
+ *  (digits and the score banner) are filled in, the rest are blank.
+ *  Each glyph is 25 bits, row-major, least significant bit first.
+ */
+
+
+#ifndef FONT5X5_1_H
+#define FONT5X5_1_H
+
+
+#include "font.h"
+
+
+static const uint8_t font5x5_1_data[] =
+{
+    0x00, 0x00, 0x00, 0x00, // ' '
+    0x00, 0x00, 0x00, 0x00, // '!'
+    0x00, 0x00, 0x00, 0x00, // '"'
+    0x00, 0x00, 0x00, 0x00, // '#'
+    0x00, 0x00, 0x00, 0x00, // '$'
+    0x00, 0x00, 0x00, 0x00, // '%'
+    0x00, 0x00, 0x00, 0x00, // '&'
+    0x00, 0x00, 0x00, 0x00, // "'"
+    0x00, 0x00, 0x00, 0x00, // '('
+    0x00, 0x00, 0x00, 0x00, // ')'
+    0x00, 0x00, 0x00, 0x00, // '*'
+    0x00, 0x00, 0x00, 0x00, // '+'
+    0x00, 0x00, 0x00, 0x00, // ','
+    0x00, 0x00, 0x00, 0x00, // '-'
+    0x00, 0x00, 0x00, 0x00, // '.'
+    0x00, 0x00, 0x00, 0x00, // '/'
+    0x2e, 0xd7, 0xe9, 0x00, // '0'
+    0xc4, 0x10, 0xe2, 0x00, // '1'
+    0x2e, 0x32, 0xf1, 0x01, // '2'
+    0x0f, 0x3a, 0xf8, 0x00, // '3'
+    0x29, 0x7d, 0x84, 0x00, // '4'
+    0x3f, 0x3c, 0xf8, 0x00, // '5'
+    0x2e, 0xbc, 0xe8, 0x00, // '6'
+    0x1f, 0x11, 0x21, 0x00, // '7'
+    0x2e, 0xba, 0xe8, 0x00, // '8'
+    0x2e, 0x7a, 0xe8, 0x00, // '9'
+    0x00, 0x00, 0x00, 0x00, // ':'
+    0x00, 0x00, 0x00, 0x00, // ';'
+    0x00, 0x00, 0x00, 0x00, // '<'
+    0x00, 0x00, 0x00, 0x00, // '='
+    0x00, 0x00, 0x00, 0x00, // '>'
+    0x00, 0x00, 0x00, 0x00, // '?'
+    0x00, 0x00, 0x00, 0x00, // '@'
+    0x00, 0x00, 0x00, 0x00, // 'A'
+    0x00, 0x00, 0x00, 0x00, // 'B'
+    0x00, 0x00, 0x00, 0x00, // 'C'
+    0x00, 0x00, 0x00, 0x00, // 'D'
+    0x00, 0x00, 0x00, 0x00, // 'E'
+    0x00, 0x00, 0x00, 0x00, // 'F'
+    0x00, 0x00, 0x00, 0x00, // 'G'
+    0x00, 0x00, 0x00, 0x00, // 'H'
+    0x00, 0x00, 0x00, 0x00, // 'I'
+    0x00, 0x00, 0x00, 0x00, // 'J'
+    0x00, 0x00, 0x00, 0x00, // 'K'
+    0x00, 0x00, 0x00, 0x00, // 'L'
+    0x00, 0x00, 0x00, 0x00, // 'M'
+    0x00, 0x00, 0x00, 0x00, // 'N'
+    0x00, 0x00, 0x00, 0x00, // 'O'
+    0x00, 0x00, 0x00, 0x00, // 'P'
+    0x00, 0x00, 0x00, 0x00, // 'Q'
+    0x00, 0x00, 0x00, 0x00, // 'R'
+    0x3e, 0x38, 0xf8, 0x00, // 'S'
+    0x00, 0x00, 0x00, 0x00, // 'T'
+    0x00, 0x00, 0x00, 0x00, // 'U'
+    0x00, 0x00, 0x00, 0x00, // 'V'
+    0x00, 0x00, 0x00, 0x00, // 'W'
+    0x00, 0x00, 0x00, 0x00, // 'X'
+    0x00, 0x00, 0x00, 0x00, // 'Y'
+    0x00, 0x00, 0x00, 0x00, // 'Z'
+    0x00, 0x00, 0x00, 0x00, // '['
+    0x00, 0x00, 0x00, 0x00, // '\\'
+    0x00, 0x00, 0x00, 0x00, // ']'
+    0x00, 0x00, 0x00, 0x00, // '^'
+    0x00, 0x00, 0x00, 0x00, // '_'
+    0x00, 0x00, 0x00, 0x00, // '`'
+    0x00, 0x00, 0x00, 0x00, // 'a'
+    0x00, 0x00, 0x00, 0x00, // 'b'
+    0xc0, 0x85, 0xe0, 0x00, // 'c'
+    0x00, 0x00, 0x00, 0x00, // 'd'
+    0x2e, 0xfe, 0xe0, 0x00, // 'e'
+    0x00, 0x00, 0x00, 0x00, // 'f'
+    0x00, 0x00, 0x00, 0x00, // 'g'
+    0x00, 0x00, 0x00, 0x00, // 'h'
+    0x00, 0x00, 0x00, 0x00, // 'i'
+    0x00, 0x00, 0x00, 0x00, // 'j'
+    0x00, 0x00, 0x00, 0x00, // 'k'
+    0x00, 0x00, 0x00, 0x00, // 'l'
+    0x00, 0x00, 0x00, 0x00, // 'm'
+    0x00, 0x00, 0x00, 0x00, // 'n'
+    0xc0, 0xc5, 0xe8, 0x00, // 'o'
+    0x00, 0x00, 0x00, 0x00, // 'p'
+    0x00, 0x00, 0x00, 0x00, // 'q'
+    0xa0, 0x8d, 0x10, 0x00, // 'r'
+    0x00, 0x00, 0x00, 0x00, // 's'
+    0x00, 0x00, 0x00, 0x00, // 't'
+    0x00, 0x00, 0x00, 0x00, // 'u'
+    0x00, 0x00, 0x00, 0x00, // 'v'
+    0x00, 0x00, 0x00, 0x00, // 'w'
+    0x00, 0x00, 0x00, 0x00, // 'x'
+    0x00, 0x00, 0x00, 0x00, // 'y'
+    0x00, 0x00, 0x00, 0x00, // 'z'
+    0x00, 0x00, 0x00, 0x00, // '{'
+    0x84, 0x10, 0x42, 0x00, // '|'
+    0x00, 0x00, 0x00, 0x00, // '}'
+    0x00, 0x00, 0x00, 0x00, // '~'
+};
+
+
+static font_t font5x5_1 =
+{
+    .flags = 0,
+    .width = 5,
+    .height = 5,
+    .offset = ' ',
+    .size = 95,
+    .bytes = 4,
+    .data = font5x5_1_data
+};
+
+
+#endif
@@ -0,0 +1,51 @@
+/** @file boing.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the boing utility.
+ */
+
+
+#include "boing.h"
+
+
+static const int8_t boing_dx[] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int8_t boing_dy[] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+
+/* Direction after bouncing off a left/right edge or a top/bottom edge. */
+static const boing_dir_t boing_flip_x[] = {DIR_N, DIR_NW, DIR_W, DIR_SW, DIR_S, DIR_SE, DIR_E, DIR_NE};
+static const boing_dir_t boing_flip_y[] = {DIR_S, DIR_SE, DIR_E, DIR_NE, DIR_N, DIR_NW, DIR_W, DIR_SW};
+
+
+boing_state_t boing_init (uint8_t xstart, uint8_t ystart, boing_dir_t dir)
+{
+    boing_state_t state;
+
+    state.pos.x = xstart;
+    state.pos.y = ystart;
+    state.dir = dir;
+
+    return state;
+}
+
+
+boing_state_t boing_update (boing_state_t state)
+{
+    int8_t x = state.pos.x + boing_dx[state.dir];
+    int8_t y = state.pos.y + boing_dy[state.dir];
+
+    if (x < 0 || x >= TINYGL_WIDTH) {
+        x = state.pos.x - boing_dx[state.dir];
+        state.dir = boing_flip_x[state.dir];
+    }
+
+    if (y < 0 || y >= TINYGL_HEIGHT) {
+        y = state.pos.y - boing_dy[state.dir];
+        state.dir = boing_flip_y[state.dir];
+    }
+
+    state.pos.x = x;
+    state.pos.y = y;
+
+    return state;
+}
@@ -0,0 +1,45 @@
+/** @file boing.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the boing utility, a ball bouncing off the
+ *  edges of the display.
+ */
+
+
+#ifndef BOING_H
+#define BOING_H
+
+
+#include "system.h"
+#include "tinygl.h"
+
+
+typedef enum dir {DIR_N, DIR_NE, DIR_E, DIR_SE, DIR_S, DIR_SW, DIR_W, DIR_NW} boing_dir_t;
+
+
+typedef struct boing_state_struct
+{
+    tinygl_point_t pos;
+    boing_dir_t dir;
+} boing_state_t;
+
+
+/**
+ * Creates a ball.
+ * @param xstart - The starting x position
+ * @param ystart - The starting y position
+ * @param dir - The starting direction
+ * @return The ball state
+ */
+boing_state_t boing_init (uint8_t xstart, uint8_t ystart, boing_dir_t dir);
+
+
+/**
+ * Moves the ball one step, bouncing off the edges of the display.
+ * @param state - The current ball state
+ * @return The new ball state
+ */
+boing_state_t boing_update (boing_state_t state);
+
+
+#endif
@@ -0,0 +1,15 @@
+/** @file config.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the UCFK4 board configuration.
+ */
+
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+
+#define LED1_PIO PIO_DEFINE (PORT_C, 2)
+
+
+#endif
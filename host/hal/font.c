@@ -0,0 +1,22 @@
+/** @file font.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the funkit font support. Glyphs are stored
+ *  row-major, one bit per pixel.
+ */
+
+
+#include "font.h"
+
+
+bool font_pixel_get (font_t *font, char ch, uint8_t col, uint8_t row)
+{
+    uint8_t index = (uint8_t) ch - font->offset;
+    uint16_t bit = row * font->width + col;
+
+    if (index >= font->size || col >= font->width || row >= font->height) {
+        return false;
+    }
+
+    return (font->data[index * font->bytes + bit / 8] >> (bit % 8)) & 1;
+}
@@ -0,0 +1,38 @@
+/** @file font.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the funkit font support.
+ */
+
+
+#ifndef FONT_H
+#define FONT_H
+
+
+#include "system.h"
+
+
+typedef struct font_struct
+{
+    uint8_t flags;
+    uint8_t width;
+    uint8_t height;
+    uint8_t offset;
+    uint8_t size;
+    uint8_t bytes;
+    const uint8_t *data;
+} font_t;
+
+
+/**
+ * Reads a single pixel of a glyph.
+ * @param font - The font
+ * @param ch - The character
+ * @param col - The glyph column
+ * @param row - The glyph row
+ * @return true if the pixel is lit
+ */
+bool font_pixel_get (font_t *font, char ch, uint8_t col, uint8_t row);
+
+
+#endif
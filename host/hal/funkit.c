@@ -0,0 +1,64 @@
+/** @file funkit.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Simulated UC funkit used by the host build.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include "funkit.h"
+#include "timer.h"
+
+
+static Funkit funkit_default;
+
+
+_Thread_local Funkit *funkit_current = &funkit_default;
+
+
+void funkit_init (Funkit *funkit)
+{
+    memset (funkit, 0, sizeof (*funkit));
+    funkit->ir_peer = funkit;
+}
+
+
+void funkit_select (Funkit *funkit)
+{
+    funkit_current = funkit;
+}
+
+
+void funkit_link (Funkit *a, Funkit *b)
+{
+    a->ir_peer = b;
+    b->ir_peer = a;
+}
+
+
+bool funkit_running (const Funkit *funkit)
+{
+    return funkit->clock_limit == 0 || funkit->clock < funkit->clock_limit;
+}
+
+
+void funkit_dump (const Funkit *funkit)
+{
+    int x;
+    int y;
+
+    for (y = 0; y < TINYGL_HEIGHT; y++) {
+        for (x = 0; x < TINYGL_WIDTH; x++) {
+            fputc ((funkit->display[x] >> y) & 1 ? '#' : '.', stderr);
+        }
+        fputc ('\n', stderr);
+    }
+
+    fprintf (stderr, "time %.3f s, pixel writes %lu, ir tx %lu rx %lu dropped %lu\n",
+             (double) funkit->clock / TIMER_RATE,
+             (unsigned long) funkit->pixel_writes,
+             (unsigned long) funkit->ir_tx_count,
+             (unsigned long) funkit->ir_rx_count,
+             (unsigned long) funkit->ir_dropped);
+}
@@ -0,0 +1,110 @@
+/** @file funkit.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Simulated UC funkit used by the host build. Each board owns its
+ *  LED matrix, IR receive queue, navswitch script, PIO pins and virtual
+ *  clock. The HAL stand-ins act on funkit_current, so several boards can
+ *  share one process by selecting each in turn, and each thread selects
+ *  boards of its own.
+ */
+
+
+#ifndef FUNKIT_H
+#define FUNKIT_H
+
+
+#include <stddef.h>
+#include "system.h"
+#include "pio.h"
+#include "tinygl.h"
+
+
+#define FUNKIT_IR_QUEUE_SIZE 64
+#define FUNKIT_TEXT_SIZE 32
+
+
+typedef struct funkit_s Funkit;
+
+
+typedef struct ir_link_s Ir_Link;
+
+
+struct funkit_s
+{
+    uint16_t display[TINYGL_WIDTH]; // one bitmap per column, bit y lit
+    uint32_t pixel_writes;
+
+    font_t *font;
+    char text[FUNKIT_TEXT_SIZE];
+    uint16_t text_len; // text length in columns, 0 when no text
+    uint16_t text_offset;
+    uint16_t text_period; // updates per scroll step
+    uint16_t text_count;
+    uint16_t update_rate;
+    uint8_t text_speed;
+
+    char ir_queue[FUNKIT_IR_QUEUE_SIZE];
+    uint8_t ir_head;
+    uint8_t ir_tail;
+    Funkit *ir_peer; // receives our transmissions
+    Ir_Link *ir_tx_link; // if set, carries our transmissions instead, see ir_link.h
+    Ir_Link *ir_rx_link; // if set, the only source of received bytes
+    uint32_t ir_tx_count;
+    uint32_t ir_rx_count;
+    uint32_t ir_dropped;
+
+    const char *nav_script;
+    uint32_t nav_pos;
+    uint8_t nav_down;
+    uint8_t nav_prev;
+
+    uint8_t pio_ports[PORT_NUM];
+
+    uint32_t clock; // timer ticks since power on
+    uint32_t clock_limit; // run until this time, 0 to run forever
+};
+
+
+/* Each thread selects its own board, so matches can run on several
+ * threads at once. */
+extern _Thread_local Funkit *funkit_current;
+
+
+/**
+ * Powers on a board. The board starts with its IR looped back to itself.
+ * @param funkit - The board
+ */
+void funkit_init (Funkit *funkit);
+
+
+/**
+ * Makes a board the target of the HAL stand-ins.
+ * @param funkit - The board
+ */
+void funkit_select (Funkit *funkit);
+
+
+/**
+ * Points two boards' IR at each other.
+ * @param a - The first board
+ * @param b - The second board
+ */
+void funkit_link (Funkit *a, Funkit *b);
+
+
+/**
+ * Returns whether a board is still inside its run limit.
+ * @param funkit - The board
+ * @return true while the board should keep running
+ */
+bool funkit_running (const Funkit *funkit);
+
+
+/**
+ * Prints the board's LED matrix and counters.
+ * @param funkit - The board
+ */
+void funkit_dump (const Funkit *funkit);
+
+
+#endif
@@ -0,0 +1,136 @@
+/** @file ir_link.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 16 Nov 19
+ *  @brief One direction of a simulated IR link that can lose, corrupt
+ *  and delay bytes.
+ */
+
+
+#include "ir_link.h"
+#include "timer.h"
+
+
+#define IR_LINK_MASK (IR_LINK_SIZE - 1)
+
+
+_Static_assert ((IR_LINK_SIZE & IR_LINK_MASK) == 0, "IR_LINK_SIZE must be a power of two");
+
+
+static uint32_t ir_link_random (Ir_Link *link)
+{
+    uint32_t x = link->rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    link->rng = x;
+
+    return x;
+}
+
+
+static uint32_t ir_link_chance (double chance)
+{
+    if (chance <= 0) {
+        return 0;
+    }
+
+    return chance >= 1 ? UINT32_MAX : chance * 4294967296.0;
+}
+
+
+void ir_link_init (Ir_Link *link, const Ir_Link_Config *config, uint32_t seed)
+{
+    atomic_init (&link->head, 0);
+    atomic_init (&link->tail, 0);
+
+    link->latency = config->latency_ms * TIMER_RATE / 1000;
+    link->jitter = config->jitter_ms * TIMER_RATE / 1000;
+    link->drop = ir_link_chance (config->drop);
+    link->corrupt = ir_link_chance (config->corrupt);
+    link->rng = seed * 2654435761u | 1;
+    link->last_due = 0;
+    link->sent = 0;
+    link->dropped = 0;
+    link->corrupted = 0;
+    link->overflowed = 0;
+    link->delivered = 0;
+}
+
+
+void ir_link_connect (Funkit *a, Funkit *b, Ir_Link *a_to_b, Ir_Link *b_to_a)
+{
+    a->ir_tx_link = a_to_b;
+    a->ir_rx_link = b_to_a;
+    b->ir_tx_link = b_to_a;
+    b->ir_rx_link = a_to_b;
+}
+
+
+void ir_link_send (Ir_Link *link, uint8_t byte, uint32_t now)
+{
+    uint32_t tail = atomic_load_explicit (&link->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit (&link->head, memory_order_acquire);
+    uint32_t due = now + link->latency;
+    Ir_Link_Slot *slot;
+
+    link->sent++;
+
+    if (link->drop && ir_link_random (link) < link->drop) {
+        link->dropped++;
+        return;
+    }
+
+    if (link->corrupt && ir_link_random (link) < link->corrupt) {
+        byte ^= 1 << (ir_link_random (link) & 7);
+        link->corrupted++;
+    }
+
+    if (tail - head == IR_LINK_SIZE) {
+        link->overflowed++;
+        return;
+    }
+
+    if (link->jitter) {
+        due += ir_link_random (link) % (link->jitter + 1);
+    }
+
+    /* Bytes stay in order behind a late one. */
+    if ((int32_t) (due - link->last_due) < 0) {
+        due = link->last_due;
+    }
+    link->last_due = due;
+
+    slot = &link->slots[tail & IR_LINK_MASK];
+    slot->byte = byte;
+    slot->due = due;
+
+    atomic_store_explicit (&link->tail, tail + 1, memory_order_release);
+}
+
+
+bool ir_link_ready_p (Ir_Link *link, uint32_t now)
+{
+    uint32_t head = atomic_load_explicit (&link->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit (&link->tail, memory_order_acquire);
+
+    return head != tail && (int32_t) (now - link->slots[head & IR_LINK_MASK].due) >= 0;
+}
+
+
+uint8_t ir_link_receive (Ir_Link *link, uint32_t now)
+{
+    uint32_t head = atomic_load_explicit (&link->head, memory_order_relaxed);
+    uint8_t byte;
+
+    if (!ir_link_ready_p (link, now)) {
+        return 0;
+    }
+
+    byte = link->slots[head & IR_LINK_MASK].byte;
+    link->delivered++;
+
+    atomic_store_explicit (&link->head, head + 1, memory_order_release);
+
+    return byte;
+}
@@ -0,0 +1,122 @@
+/** @file ir_link.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 16 Nov 19
+ *  @brief One direction of a simulated IR link that can lose, corrupt
+ *  and delay bytes. A link is a lock-free single producer, single
+ *  consumer queue: the sending board writes the tail and the receiving
+ *  board the head, so the two boards can be stepped on different threads.
+ *
+ *  Each byte is stamped with the time it is due at the receiver, the
+ *  sender's clock plus the latency and a random jitter, and is only read
+ *  once the receiver's clock has reached it. Like the UART, the link
+ *  never reorders bytes, so a byte is never due before the one ahead of
+ *  it. Bytes sent to a full queue are lost.
+ */
+
+
+#ifndef IR_LINK_H
+#define IR_LINK_H
+
+
+#include <stdatomic.h>
+#include "system.h"
+#include "funkit.h"
+
+
+#define IR_LINK_SIZE 64 // bytes in flight, a power of two
+
+
+typedef struct ir_link_config_s Ir_Link_Config;
+
+
+typedef struct ir_link_slot_s Ir_Link_Slot;
+
+
+struct ir_link_config_s
+{
+    double latency_ms;
+    double jitter_ms; // up to this much is added to the latency of each byte
+    double drop; // chance of a byte being lost, 0 to 1
+    double corrupt; // chance of a byte having a bit flipped, 0 to 1
+};
+
+
+struct ir_link_slot_s
+{
+    uint32_t due; // receiver clock time the byte arrives at
+    uint8_t byte;
+};
+
+
+struct ir_link_s
+{
+    Ir_Link_Slot slots[IR_LINK_SIZE];
+    _Atomic uint32_t head; // written only by the receiver
+    _Atomic uint32_t tail; // written only by the sender
+
+    /* The sender's side. */
+    uint32_t latency; // timer ticks
+    uint32_t jitter; // timer ticks
+    uint32_t drop; // chance out of 2^32
+    uint32_t corrupt; // chance out of 2^32
+    uint32_t rng; // xorshift32 state, never 0
+    uint32_t last_due;
+    uint32_t sent;
+    uint32_t dropped;
+    uint32_t corrupted;
+    uint32_t overflowed; // lost to a full queue
+
+    /* The receiver's side. */
+    uint32_t delivered;
+};
+
+
+/**
+ * Empties a link and sets how it treats bytes.
+ * @param link - The link
+ * @param config - The latency, jitter and loss of the link
+ * @param seed - Seeds the link's random choices
+ */
+void ir_link_init (Ir_Link *link, const Ir_Link_Config *config, uint32_t seed);
+
+
+/**
+ * Points two boards' IR at each other through a pair of links, in place
+ * of the perfect link funkit_link gives.
+ * @param a - The first board
+ * @param b - The second board
+ * @param a_to_b - The link carrying the first board's bytes
+ * @param b_to_a - The link carrying the second board's bytes
+ */
+void ir_link_connect (Funkit *a, Funkit *b, Ir_Link *a_to_b, Ir_Link *b_to_a);
+
+
+/**
+ * Sends a byte. Called only by the sending board.
+ * @param link - The link
+ * @param byte - The byte
+ * @param now - The sender's clock
+ */
+void ir_link_send (Ir_Link *link, uint8_t byte, uint32_t now);
+
+
+/**
+ * Returns whether a byte has arrived. Called only by the receiving board.
+ * @param link - The link
+ * @param now - The receiver's clock
+ * @return true if ir_link_receive has a byte to return
+ */
+bool ir_link_ready_p (Ir_Link *link, uint32_t now);
+
+
+/**
+ * Takes the next byte that has arrived. Called only by the receiving
+ * board.
+ * @param link - The link
+ * @param now - The receiver's clock
+ * @return The byte, or 0 if none has arrived
+ */
+uint8_t ir_link_receive (Ir_Link *link, uint32_t now);
+
+
+#endif
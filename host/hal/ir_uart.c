@@ -0,0 +1,92 @@
+/** @file ir_uart.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the IR UART driver.
+ */
+
+
+#include "ir_uart.h"
+#include "funkit.h"
+#include "ir_link.h"
+
+
+int8_t ir_uart_init (void)
+{
+    funkit_current->ir_head = 0;
+    funkit_current->ir_tail = 0;
+
+    return 1;
+}
+
+
+void ir_uart_putc (char ch)
+{
+    Funkit *peer = funkit_current->ir_peer;
+    uint8_t next;
+
+    funkit_current->ir_tx_count++;
+
+    if (funkit_current->ir_tx_link) {
+        ir_link_send (funkit_current->ir_tx_link, ch, funkit_current->clock);
+        return;
+    }
+
+    next = (peer->ir_tail + 1) % FUNKIT_IR_QUEUE_SIZE;
+    if (next == peer->ir_head) {
+        peer->ir_dropped++;
+        return;
+    }
+
+    peer->ir_queue[peer->ir_tail] = ch;
+    peer->ir_tail = next;
+}
+
+
+void ir_uart_puts (const char *str)
+{
+    while (*str) {
+        ir_uart_putc (*str++);
+    }
+}
+
+
+bool ir_uart_read_ready_p (void)
+{
+    if (funkit_current->ir_rx_link) {
+        return ir_link_ready_p (funkit_current->ir_rx_link, funkit_current->clock);
+    }
+
+    return funkit_current->ir_head != funkit_current->ir_tail;
+}
+
+
+bool ir_uart_write_ready_p (void)
+{
+    return true;
+}
+
+
+char ir_uart_getc (void)
+{
+    Funkit *funkit = funkit_current;
+    char ch;
+
+    if (funkit->ir_rx_link) {
+        if (!ir_link_ready_p (funkit->ir_rx_link, funkit->clock)) {
+            return '\0';
+        }
+
+        funkit->ir_rx_count++;
+        return ir_link_receive (funkit->ir_rx_link, funkit->clock);
+    }
+
+    if (funkit->ir_head == funkit->ir_tail) {
+        return '\0';
+    }
+
+    ch = funkit->ir_queue[funkit->ir_head];
+    funkit->ir_head = (funkit->ir_head + 1) % FUNKIT_IR_QUEUE_SIZE;
+    funkit->ir_rx_count++;
+
+    return ch;
+}
@@ -0,0 +1,58 @@
+/** @file ir_uart.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the IR UART driver. Transmitted bytes are
+ *  queued on the linked peer board, which is the board itself by default.
+ */
+
+
+#ifndef IR_UART_H
+#define IR_UART_H
+
+
+#include "system.h"
+
+
+/**
+ * Initialises the IR UART.
+ * @return 1 on success
+ */
+int8_t ir_uart_init (void);
+
+
+/**
+ * Transmits a character. Characters sent to a full queue are dropped.
+ * @param ch - The character to send
+ */
+void ir_uart_putc (char ch);
+
+
+/**
+ * Transmits a string.
+ * @param str - The string to send
+ */
+void ir_uart_puts (const char *str);
+
+
+/**
+ * Returns whether a received character is waiting.
+ * @return true if ir_uart_getc will not block
+ */
+bool ir_uart_read_ready_p (void);
+
+
+/**
+ * Returns whether a character can be transmitted.
+ * @return Always true on the host
+ */
+bool ir_uart_write_ready_p (void);
+
+
+/**
+ * Reads a received character.
+ * @return The character, or '\0' if none is waiting
+ */
+char ir_uart_getc (void);
+
+
+#endif
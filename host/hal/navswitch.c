@@ -0,0 +1,73 @@
+/** @file navswitch.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the navswitch driver. The script is a string
+ *  with one character per poll: 'N', 'E', 'S', 'W' or 'P' holds that
+ *  switch down, anything else leaves all switches up. The script loops.
+ */
+
+
+#include "navswitch.h"
+#include "funkit.h"
+
+
+static uint8_t navswitch_decode (char ch)
+{
+    switch (ch) {
+        case 'N':
+            return BIT (NAVSWITCH_NORTH);
+        case 'E':
+            return BIT (NAVSWITCH_EAST);
+        case 'S':
+            return BIT (NAVSWITCH_SOUTH);
+        case 'W':
+            return BIT (NAVSWITCH_WEST);
+        case 'P':
+            return BIT (NAVSWITCH_PUSH);
+        default:
+            return 0;
+    }
+}
+
+
+void navswitch_init (void)
+{
+    funkit_current->nav_down = 0;
+    funkit_current->nav_prev = 0;
+}
+
+
+void navswitch_update (void)
+{
+    Funkit *funkit = funkit_current;
+
+    funkit->nav_prev = funkit->nav_down;
+    funkit->nav_down = 0;
+
+    if (funkit->nav_script != NULL && funkit->nav_script[0] != '\0') {
+        funkit->nav_down = navswitch_decode (funkit->nav_script[funkit->nav_pos]);
+        funkit->nav_pos++;
+
+        if (funkit->nav_script[funkit->nav_pos] == '\0') {
+            funkit->nav_pos = 0;
+        }
+    }
+}
+
+
+bool navswitch_down_p (uint8_t navswitch)
+{
+    return (funkit_current->nav_down & BIT (navswitch)) != 0;
+}
+
+
+bool navswitch_push_event_p (uint8_t navswitch)
+{
+    return ((funkit_current->nav_down & ~funkit_current->nav_prev) & BIT (navswitch)) != 0;
+}
+
+
+bool navswitch_release_event_p (uint8_t navswitch)
+{
+    return ((~funkit_current->nav_down & funkit_current->nav_prev) & BIT (navswitch)) != 0;
+}
@@ -0,0 +1,55 @@
+/** @file navswitch.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the navswitch driver. Presses come from the
+ *  current simulated board's navswitch script.
+ */
+
+
+#ifndef NAVSWITCH_H
+#define NAVSWITCH_H
+
+
+#include "system.h"
+
+
+enum {NAVSWITCH_NORTH, NAVSWITCH_EAST, NAVSWITCH_SOUTH, NAVSWITCH_WEST, NAVSWITCH_PUSH};
+
+
+/**
+ * Initialises the navswitch.
+ */
+void navswitch_init (void);
+
+
+/**
+ * Polls the navswitch. Each call consumes one character of the script.
+ */
+void navswitch_update (void);
+
+
+/**
+ * Returns whether a switch is held down.
+ * @param navswitch - The switch to check
+ * @return true if held down
+ */
+bool navswitch_down_p (uint8_t navswitch);
+
+
+/**
+ * Returns whether a switch was pressed at the last poll.
+ * @param navswitch - The switch to check
+ * @return true if newly pressed
+ */
+bool navswitch_push_event_p (uint8_t navswitch);
+
+
+/**
+ * Returns whether a switch was released at the last poll.
+ * @param navswitch - The switch to check
+ * @return true if newly released
+ */
+bool navswitch_release_event_p (uint8_t navswitch);
+
+
+#endif
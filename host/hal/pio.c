@@ -0,0 +1,47 @@
+/** @file pio.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the PIO driver.
+ */
+
+
+#include "pio.h"
+#include "funkit.h"
+
+
+#define PIO_PORT(pio) ((pio) >> 8)
+#define PIO_BIT(pio) (BIT ((pio) & 0xff))
+
+
+void pio_config_set (pio_t pio, pio_config_t config)
+{
+    if (config == PIO_OUTPUT_HIGH) {
+        pio_output_high (pio);
+    } else {
+        pio_output_low (pio);
+    }
+}
+
+
+void pio_output_high (pio_t pio)
+{
+    funkit_current->pio_ports[PIO_PORT (pio)] |= PIO_BIT (pio);
+}
+
+
+void pio_output_low (pio_t pio)
+{
+    funkit_current->pio_ports[PIO_PORT (pio)] &= ~PIO_BIT (pio);
+}
+
+
+void pio_output_toggle (pio_t pio)
+{
+    funkit_current->pio_ports[PIO_PORT (pio)] ^= PIO_BIT (pio);
+}
+
+
+uint8_t pio_input_get (pio_t pio)
+{
+    return (funkit_current->pio_ports[PIO_PORT (pio)] & PIO_BIT (pio)) != 0;
+}
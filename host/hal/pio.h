@@ -0,0 +1,65 @@
+/** @file pio.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the PIO driver. Pin states are kept per
+ *  simulated board.
+ */
+
+
+#ifndef PIO_H
+#define PIO_H
+
+
+#include "system.h"
+
+
+#define PIO_DEFINE(PORT, PORTBIT) (((PORT) << 8) | (PORTBIT))
+
+
+enum {PORT_B, PORT_C, PORT_D, PORT_NUM};
+
+
+typedef uint16_t pio_t;
+
+
+typedef enum pio_config_enum {PIO_INPUT, PIO_PULLUP, PIO_OUTPUT_LOW, PIO_OUTPUT_HIGH} pio_config_t;
+
+
+/**
+ * Configures a pin.
+ * @param pio - The pin to configure
+ * @param config - The pin configuration
+ */
+void pio_config_set (pio_t pio, pio_config_t config);
+
+
+/**
+ * Drives a pin high.
+ * @param pio - The pin to drive
+ */
+void pio_output_high (pio_t pio);
+
+
+/**
+ * Drives a pin low.
+ * @param pio - The pin to drive
+ */
+void pio_output_low (pio_t pio);
+
+
+/**
+ * Toggles a pin.
+ * @param pio - The pin to toggle
+ */
+void pio_output_toggle (pio_t pio);
+
+
+/**
+ * Reads a pin.
+ * @param pio - The pin to read
+ * @return 1 if the pin is high, 0 otherwise
+ */
+uint8_t pio_input_get (pio_t pio);
+
+
+#endif
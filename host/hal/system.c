@@ -0,0 +1,39 @@
+/** @file system.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for system initialisation.
+ */
+
+
+#include <stdlib.h>
+#include "system.h"
+#include "timer.h"
+#include "funkit.h"
+
+
+#define DEFAULT_RUN_SECONDS 10
+
+
+static void system_exit (void)
+{
+    if (getenv ("FUNKIT_DUMP") != NULL) {
+        funkit_dump (funkit_current);
+    }
+}
+
+
+void system_init (void)
+{
+    const char *seconds = getenv ("FUNKIT_SECONDS");
+    const char *script = getenv ("FUNKIT_NAVSWITCH");
+    double run_seconds = seconds ? atof (seconds) : DEFAULT_RUN_SECONDS;
+
+    if (funkit_current->ir_peer == NULL) {
+        funkit_init (funkit_current);
+    }
+
+    funkit_current->clock_limit = funkit_current->clock + run_seconds * TIMER_RATE;
+    funkit_current->nav_script = script;
+
+    atexit (system_exit);
+}
@@ -0,0 +1,39 @@
+/** @file system.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the funkit system header. Provides the same
+ *  types and helper macros as drivers/avr/system.h so the game modules
+ *  compile unchanged on a PC.
+ */
+
+
+#ifndef SYSTEM_H
+#define SYSTEM_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+
+#define F_CPU 8000000
+
+
+#define __unused__ __attribute__ ((unused))
+
+
+#define ARRAY_SIZE(array) (sizeof (array) / sizeof (array[0]))
+
+
+#define BIT(X) (1 << (X))
+
+
+/**
+ * Initialises the simulated board. Reads the FUNKIT_SECONDS and
+ * FUNKIT_NAVSWITCH environment variables to set the run length and
+ * navswitch script.
+ */
+void system_init (void);
+
+
+#endif
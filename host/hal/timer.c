@@ -0,0 +1,30 @@
+/** @file timer.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the timer driver.
+ */
+
+
+#include "timer.h"
+#include "funkit.h"
+
+
+void timer_init (void)
+{
+}
+
+
+timer_tick_t timer_get (void)
+{
+    return (timer_tick_t) funkit_current->clock;
+}
+
+
+timer_tick_t timer_wait_until (timer_tick_t when)
+{
+    timer_tick_t delta = when - timer_get ();
+
+    funkit_current->clock += delta;
+
+    return when;
+}
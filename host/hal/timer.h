@@ -0,0 +1,48 @@
+/** @file timer.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the timer driver. Time is the current
+ *  simulated board's virtual clock and only moves when the game waits
+ *  on it or a tool advances it, so simulations run as fast as the host
+ *  allows.
+ */
+
+
+#ifndef TIMER_H
+#define TIMER_H
+
+
+#include "system.h"
+
+
+#define TIMER_CLOCK_DIVISOR 1024
+
+
+#define TIMER_RATE (F_CPU / TIMER_CLOCK_DIVISOR)
+
+
+typedef uint16_t timer_tick_t;
+
+
+/**
+ * Initialises the timer.
+ */
+void timer_init (void);
+
+
+/**
+ * Returns the current time.
+ * @return The time in timer ticks
+ */
+timer_tick_t timer_get (void);
+
+
+/**
+ * Advances the clock until the given time.
+ * @param when - The time to wait for
+ * @return The time
+ */
+timer_tick_t timer_wait_until (timer_tick_t when);
+
+
+#endif
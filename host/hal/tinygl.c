@@ -0,0 +1,133 @@
+/** @file tinygl.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the tinygl graphics library. Text scrolls
+ *  along x one column per step, one glyph row per display row.
+ */
+
+
+#include <string.h>
+#include "tinygl.h"
+#include "funkit.h"
+
+
+static void tinygl_text_render (Funkit *funkit)
+{
+    uint8_t glyph_width = funkit->font->width + 1;
+    int x;
+    int y;
+
+    for (x = 0; x < TINYGL_WIDTH; x++) {
+        uint16_t col = (funkit->text_offset + x) % funkit->text_len;
+        uint16_t index = col / glyph_width;
+        uint8_t glyph_col = col % glyph_width;
+        uint16_t bits = 0;
+
+        if (index < strlen (funkit->text) && glyph_col < funkit->font->width) {
+            for (y = 0; y < funkit->font->height && y < TINYGL_HEIGHT; y++) {
+                if (font_pixel_get (funkit->font, funkit->text[index], glyph_col, y)) {
+                    bits |= BIT (y);
+                }
+            }
+        }
+
+        funkit->display[x] = bits;
+    }
+}
+
+
+void tinygl_init (uint16_t update_rate)
+{
+    funkit_current->update_rate = update_rate;
+    tinygl_clear ();
+}
+
+
+void tinygl_font_set (font_t *font)
+{
+    funkit_current->font = font;
+}
+
+
+void tinygl_text_speed_set (uint8_t speed)
+{
+    funkit_current->text_speed = speed;
+}
+
+
+void tinygl_text_mode_set (__unused__ tinygl_text_mode_t mode)
+{
+}
+
+
+void tinygl_draw_point (tinygl_point_t point, tinygl_pixel_value_t pixel_value)
+{
+    Funkit *funkit = funkit_current;
+
+    if (point.x < 0 || point.x >= TINYGL_WIDTH || point.y < 0 || point.y >= TINYGL_HEIGHT) {
+        return;
+    }
+
+    if (pixel_value) {
+        funkit->display[point.x] |= BIT (point.y);
+    } else {
+        funkit->display[point.x] &= ~BIT (point.y);
+    }
+
+    funkit->pixel_writes++;
+}
+
+
+tinygl_pixel_value_t tinygl_pixel_get (tinygl_point_t point)
+{
+    if (point.x < 0 || point.x >= TINYGL_WIDTH || point.y < 0 || point.y >= TINYGL_HEIGHT) {
+        return 0;
+    }
+
+    return (funkit_current->display[point.x] >> point.y) & 1;
+}
+
+
+void tinygl_clear (void)
+{
+    memset (funkit_current->display, 0, sizeof (funkit_current->display));
+    funkit_current->text_len = 0;
+}
+
+
+void tinygl_text (const char *string)
+{
+    Funkit *funkit = funkit_current;
+
+    strncpy (funkit->text, string, FUNKIT_TEXT_SIZE - 1);
+    funkit->text[FUNKIT_TEXT_SIZE - 1] = '\0';
+
+    if (funkit->font == NULL) {
+        return;
+    }
+
+    /* Trailing blank columns let the text scroll fully off before repeating. */
+    funkit->text_len = strlen (funkit->text) * (funkit->font->width + 1) + TINYGL_WIDTH;
+    funkit->text_offset = 0;
+    funkit->text_count = 0;
+    funkit->text_period = funkit->text_speed ? funkit->update_rate / funkit->text_speed : 1;
+    tinygl_text_render (funkit);
+}
+
+
+void tinygl_update (void)
+{
+    Funkit *funkit = funkit_current;
+
+    if (funkit->text_len == 0) {
+        return;
+    }
+
+    funkit->text_count++;
+
+    if (funkit->text_count >= funkit->text_period) {
+        funkit->text_count = 0;
+        funkit->text_offset = (funkit->text_offset + 1) % funkit->text_len;
+        tinygl_text_render (funkit);
+    }
+}
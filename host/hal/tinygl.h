@@ -0,0 +1,118 @@
+/** @file tinygl.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 2 Nov 19
+ *  @brief Host stand-in for the tinygl graphics library. Pixels are kept
+ *  in the current simulated board's column bitmaps.
+ */
+
+
+#ifndef TINYGL_H
+#define TINYGL_H
+
+
+#include "system.h"
+#include "font.h"
+
+
+#ifndef TINYGL_WIDTH
+#define TINYGL_WIDTH 5
+#endif
+
+#ifndef TINYGL_HEIGHT
+#define TINYGL_HEIGHT 7
+#endif
+
+
+typedef int8_t tinygl_coord_t;
+
+
+typedef uint8_t tinygl_pixel_value_t;
+
+
+typedef struct tinygl_point
+{
+    tinygl_coord_t x;
+    tinygl_coord_t y;
+} tinygl_point_t;
+
+
+typedef enum {TINYGL_TEXT_MODE_STEP, TINYGL_TEXT_MODE_SCROLL} tinygl_text_mode_t;
+
+
+/**
+ * Constructs a point.
+ * @param x - The x coordinate
+ * @param y - The y coordinate
+ * @return The point
+ */
+static inline tinygl_point_t tinygl_point (tinygl_coord_t x, tinygl_coord_t y)
+{
+    tinygl_point_t point = {x, y};
+    return point;
+}
+
+
+/**
+ * Initialises the display.
+ * @param update_rate - The rate tinygl_update will be called at in Hz
+ */
+void tinygl_init (uint16_t update_rate);
+
+
+/**
+ * Selects the font used by tinygl_text.
+ * @param font - The font
+ */
+void tinygl_font_set (font_t *font);
+
+
+/**
+ * Sets the text speed.
+ * @param speed - The speed in columns per second
+ */
+void tinygl_text_speed_set (uint8_t speed);
+
+
+/**
+ * Sets the text mode.
+ * @param mode - Scrolling or stepping
+ */
+void tinygl_text_mode_set (tinygl_text_mode_t mode);
+
+
+/**
+ * Draws a single pixel. Points off the matrix are ignored.
+ * @param point - The pixel to draw
+ * @param pixel_value - 1 to light, 0 to clear
+ */
+void tinygl_draw_point (tinygl_point_t point, tinygl_pixel_value_t pixel_value);
+
+
+/**
+ * Reads a single pixel.
+ * @param point - The pixel to read
+ * @return The pixel value
+ */
+tinygl_pixel_value_t tinygl_pixel_get (tinygl_point_t point);
+
+
+/**
+ * Clears the display and stops any text.
+ */
+void tinygl_clear (void);
+
+
+/**
+ * Starts displaying a string.
+ * @param string - The string to show, copied by tinygl
+ */
+void tinygl_text (const char *string);
+
+
+/**
+ * Refreshes the display and advances scrolling text.
+ */
+void tinygl_update (void);
+
+
+#endif
@@ -0,0 +1,101 @@
+/** @file match.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 14 Nov 19
+ *  @brief A match between two bots on two simulated funkits.
+ */
+
+
+#include "system.h"
+#include "tinygl.h"
+#include "ir_uart.h"
+#include "timer.h"
+#include "game_sim.h"
+#include "match.h"
+
+
+#define MATCH_TICK_PERIOD (TIMER_RATE / GAME_TICK_RATE) // timer ticks per game tick
+
+
+/**
+ * Sets up a match with both boards powered on and playing.
+ * @param match - A pointer to the match
+ * @param a - The policy of the bot on the first board
+ * @param b - The policy of the bot on the second board
+ * @param seed - Seeds the bots, the same seed plays the same match
+ */
+void match_init (Match* match, const Bot_Policy* a, const Bot_Policy* b, uint32_t seed)
+{
+    uint8_t i;
+
+    funkit_init (&match->kits[0]);
+    funkit_init (&match->kits[1]);
+    funkit_link (&match->kits[0], &match->kits[1]);
+
+    for (i = 0; i < 2; i++) {
+        funkit_select (&match->kits[i]);
+        tinygl_init (DISPLAY_RATE);
+        ir_uart_init ();
+
+        match->games[i].replay = NULL;
+        setup_game (&match->games[i]);
+        match->games[i].state = STATE_PLAYING;
+    }
+
+    bot_init (&match->bots[0], a, 2 * seed);
+    bot_init (&match->bots[1], b, 2 * seed + 1);
+    match->ticks = 0;
+}
+
+
+/**
+ * Advances both boards by one tick, the first board then the second.
+ * Each board takes in the IR bytes that have reached it and, on input
+ * steps, its bot's presses, and its clock moves on by one game tick.
+ * @param match - A pointer to the match
+ */
+void match_tick (Match* match)
+{
+    uint8_t i;
+
+    for (i = 0; i < 2; i++) {
+        Game_Data* game_data = &match->games[i];
+        Game_Inputs inputs = {0};
+
+        funkit_select (&match->kits[i]);
+        rx_ring_fill (&game_data->rx_ring);
+
+        if (game_due_tasks (game_data) & GAME_TASK_INPUT) {
+            inputs.nav_events = bot_decide (&match->bots[i], game_data);
+        }
+
+        game_step (game_data, &inputs, 1);
+        match->kits[i].clock += MATCH_TICK_PERIOD;
+    }
+
+    match->ticks++;
+}
+
+
+/**
+ * Returns whether a match is over, won or out of time. The scores are
+ * taken from the first board.
+ * @param match - A pointer to the match
+ * @return 1 if the match is over, 0 otherwise
+ */
+uint8_t match_over (const Match* match)
+{
+    return match->games[0].own_score >= MATCH_POINTS || match->games[0].enemy_score >= MATCH_POINTS
+        || match->ticks >= MATCH_MAX_TICKS;
+}
+
+
+/**
+ * Plays a match to the end.
+ * @param match - A pointer to the match
+ */
+void match_play (Match* match)
+{
+    while (!match_over (match)) {
+        match_tick (match);
+    }
+}
@@ -0,0 +1,71 @@
+/** @file match.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 14 Nov 19
+ *  @brief A match between two bots, each playing its own simulated funkit
+ *  with the boards' IR pointed at each other. A match holds all of its
+ *  state, so any number can run side by side, on any thread.
+ */
+
+
+#ifndef MATCH_H
+#define MATCH_H
+
+
+#include "system.h"
+#include "funkit.h"
+#include "game_data.h"
+#include "bot.h"
+
+
+#define MATCH_POINTS 5 // a match is won by the first to this many points
+#define MATCH_MAX_TICKS (600ul * GAME_TICK_RATE) // ten minutes, then the match is a draw
+
+
+typedef struct match_s Match;
+
+
+struct match_s
+{
+    Funkit kits[2];
+    Game_Data games[2];
+    Bot bots[2];
+    uint32_t ticks;
+};
+
+
+/**
+ * Sets up a match with both boards powered on and playing.
+ * @param match - A pointer to the match
+ * @param a - The policy of the bot on the first board
+ * @param b - The policy of the bot on the second board
+ * @param seed - Seeds the bots, the same seed plays the same match
+ */
+void match_init (Match* match, const Bot_Policy* a, const Bot_Policy* b, uint32_t seed);
+
+
+/**
+ * Advances both boards by one tick, the first board then the second.
+ * Each board takes in the IR bytes that have reached it and, on input
+ * steps, its bot's presses, and its clock moves on by one game tick.
+ * @param match - A pointer to the match
+ */
+void match_tick (Match* match);
+
+
+/**
+ * Returns whether a match is over, won or out of time. The scores are
+ * taken from the first board.
+ * @param match - A pointer to the match
+ * @return 1 if the match is over, 0 otherwise
+ */
+uint8_t match_over (const Match* match);
+
+
+/**
+ * Plays a match to the end.
+ * @param match - A pointer to the match
+ */
+void match_play (Match* match);
+
+
+#endif
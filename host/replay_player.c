@@ -0,0 +1,169 @@
+/** @file replay_player.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 9 Nov 19
+ *  @brief Plays a replay log back into a fresh game as fast as the host
+ *  allows and prints how the game ended, so runs can be compared.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "system.h"
+#include "tinygl.h"
+#include "funkit.h"
+#include "game_data.h"
+#include "game_sim.h"
+#include "replay.h"
+
+
+#define PLAYER_MAX_STEP 60000 // ticks per game_step call
+
+
+static Funkit player_kit;
+
+
+static Game_Data game_data;
+
+
+/**
+ * Reads a whole file into memory.
+ * @param path - The file
+ * @param len - Set to the length of the file
+ * @return The contents, or NULL if the file could not be read
+ */
+static uint8_t* read_file (const char* path, uint32_t* len)
+{
+    FILE* file = fopen (path, "rb");
+    uint8_t* data;
+    long size;
+
+    if (file == NULL) {
+        return NULL;
+    }
+
+    fseek (file, 0, SEEK_END);
+    size = ftell (file);
+    fseek (file, 0, SEEK_SET);
+
+    data = malloc (size > 0 ? size : 1);
+    if (data != NULL && fread (data, 1, size, file) != (size_t) size) {
+        free (data);
+        data = NULL;
+    }
+    fclose (file);
+
+    *len = size;
+    return data;
+}
+
+
+/**
+ * Advances the game by a number of ticks with no inputs.
+ * @param ticks - The number of ticks
+ */
+static void run_idle (uint32_t ticks)
+{
+    Game_Inputs none = {0};
+
+    while (ticks > 0) {
+        uint16_t step = ticks > PLAYER_MAX_STEP ? PLAYER_MAX_STEP : ticks;
+
+        game_step (&game_data, &none, step);
+        ticks -= step;
+    }
+}
+
+
+/**
+ * Plays a replay log back and prints the final state of the game.
+ */
+int main (int argc, char** argv)
+{
+    Replay_Reader reader;
+    Replay_Record record;
+    Game_Inputs inputs = {0};
+    uint32_t tick = 0;
+    uint32_t records = 0;
+    uint32_t len;
+    uint8_t* data;
+    uint8_t ended = 0;
+    uint16_t dropped = 0;
+    uint8_t i;
+
+    if (argc != 2) {
+        fprintf (stderr, "usage: %s replay-log\n", argv[0]);
+        return 1;
+    }
+
+    data = read_file (argv[1], &len);
+    if (data == NULL) {
+        perror (argv[1]);
+        return 1;
+    }
+
+    funkit_init (&player_kit);
+    funkit_select (&player_kit);
+    tinygl_init (DISPLAY_RATE);
+
+    setup_game (&game_data);
+    game_data.state = STATE_PLAYING;
+
+    replay_reader_init (&reader, data, len);
+
+    /* Received bytes come only from the log, what the game sends is never
+     * read back. Inputs logged on one tick are collected and the tick is
+     * run once the log moves past it. */
+    while (replay_next (&reader, &record)) {
+        if (record.tick > tick) {
+            game_step (&game_data, &inputs, 1);
+            inputs.nav_events = 0;
+            run_idle (record.tick - tick - 1);
+            tick = record.tick;
+        }
+
+        if (record.tag == REPLAY_TAG_END) {
+            ended = 1;
+            break;
+        }
+
+        if (record.tag == REPLAY_TAG_DROPPED) {
+            dropped = record.dropped;
+            continue;
+        }
+
+        if (record.tag == REPLAY_TAG_NAV) {
+            inputs.nav_events |= record.nav_events;
+        }
+
+        for (i = 0; i < record.rx_count; i++) {
+            rx_ring_push (&game_data.rx_ring, record.rx_bytes[i]);
+        }
+
+        records++;
+    }
+
+    if (!ended) {
+        game_step (&game_data, &inputs, 1);
+        tick++;
+        fprintf (stderr, "%s: log is cut short\n", argv[1]);
+    }
+
+    if (dropped != 0) {
+        fprintf (stderr, "%s: log filled up, %u records after it were not kept\n", argv[1], dropped);
+    }
+
+    printf ("ticks %lu records %lu score %u|%u state %u bullets %u frames ok %u bad %u lost %u\n",
+            (unsigned long) tick, (unsigned long) records, game_data.own_score,
+            game_data.enemy_score, game_data.state, (unsigned) game_data.bullets.count,
+            game_data.rx.frames_ok, game_data.rx.frames_bad, game_data.rx.frames_lost);
+    printf ("pixels drawn %lu written %lu saved %lu\n", (unsigned long) game_data.fb.draw_count,
+            (unsigned long) game_data.fb.write_count,
+            (unsigned long) (game_data.fb.draw_count - game_data.fb.write_count));
+
+    if (getenv ("FUNKIT_DUMP") != NULL) {
+        funkit_dump (&player_kit);
+    }
+
+    free (data);
+    return ended && dropped == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/** @file score_check.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 17 Nov 19
+ *  @brief Checks the score banner for every pair of scores. The text from
+ *  score_format must match snprintf, and the banner's columns must match
+ *  the font's glyphs for that text, both when first built and when it is
+ *  rebuilt for new scores.
+ */
+
+
+#include <stdio.h>
+#include <string.h>
+#include "system.h"
+#include "font.h"
+#include "framebuffer.h"
+#include "score.h"
+#include "../fonts/font5x5_1.h"
+
+
+/**
+ * Checks a banner's columns against the font's glyphs for a text.
+ * @param banner - The banner
+ * @param text - The text it should show
+ * @param fb - The framebuffer it was shown in
+ * @return 1 if the banner matches, 0 otherwise
+ */
+static uint8_t check_banner (const Score_Banner* banner, const char* text, const Framebuffer* fb)
+{
+    uint8_t len = strlen (text);
+    uint8_t i;
+    uint8_t col;
+    uint8_t row;
+
+    if (banner->len != len * (SCORE_FONT_WIDTH + 1)) {
+        return 0;
+    }
+
+    for (i = 0; i < len; i++) {
+        for (col = 0; col <= SCORE_FONT_WIDTH; col++) {
+            uint8_t bits = banner->cols[i * (SCORE_FONT_WIDTH + 1) + col];
+
+            for (row = 0; row < 8; row++) {
+                bool lit = col < SCORE_FONT_WIDTH && row < TINYGL_HEIGHT
+                           && font_pixel_get (&font5x5_1, text[i], col, row);
+
+                if (((bits >> row) & 1) != lit) {
+                    return 0;
+                }
+            }
+        }
+    }
+
+    /* The banner is shown from its first column. */
+    for (col = 0; col < TINYGL_WIDTH; col++) {
+        if (fb->next.cols[col] != (col < banner->len ? banner->cols[col] : 0)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * Runs the checks and prints the number of failures.
+ * @return 0 if every pair passed, 1 otherwise
+ */
+int main (void)
+{
+    static Framebuffer fb;
+    Score_Banner banner;
+    char expected[SCORE_TEXT_SIZE];
+    char text[SCORE_TEXT_SIZE];
+    uint32_t failures = 0;
+    uint16_t own;
+    uint16_t enemy;
+
+    framebuffer_init (&fb);
+    score_banner_init (&banner);
+
+    for (own = 0; own <= UINT8_MAX; own++) {
+        for (enemy = 0; enemy <= UINT8_MAX; enemy++) {
+            uint8_t len = score_format (text, own, enemy);
+
+            snprintf (expected, sizeof (expected), "Score %u|%u", own, enemy);
+
+            if (len != strlen (expected) || strcmp (text, expected) != 0) {
+                fprintf (stderr, "score_format %u|%u gave \"%s\", expected \"%s\"\n", own, enemy, text, expected);
+                failures++;
+                continue;
+            }
+
+            score_banner_show (&banner, own, enemy, &fb);
+
+            if (!check_banner (&banner, expected, &fb)) {
+                fprintf (stderr, "score banner %u|%u does not match the font\n", own, enemy);
+                failures++;
+            }
+        }
+    }
+
+    printf ("score check: %lu score pairs, %lu failed\n", (unsigned long) (UINT8_MAX + 1) * (UINT8_MAX + 1),
+            (unsigned long) failures);
+
+    return failures != 0;
+}
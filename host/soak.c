@@ -0,0 +1,272 @@
+/** @file soak.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 16 Nov 19
+ *  @brief Soaks the game under a bad IR link. Plays bot matches with each
+ *  board's bytes going through an ir_link that loses, corrupts and delays
+ *  them, and counts the ways the two boards fall out of step:
+ *
+ *  - the boards still disagree on the score SOAK_SETTLE_TICKS after the
+ *    match ended, every resend of a hit count was lost
+ *  - one board stays on the score screen while the other plays on for
+ *    longer than SOAK_STUCK_TICKS
+ *  - both boards stay on the score screen for longer than that
+ *
+ *  The soak fails if the scores disagree in any match.
+ *
+ *  Matches are handed out to the threads one at a time from a shared
+ *  counter. Each match and its links are seeded by the match's number.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "system.h"
+#include "game_sim.h"
+#include "ir_link.h"
+#include "match.h"
+
+
+#define SOAK_MATCHES 200
+#define SOAK_STUCK_TICKS (2 * GAME_TICK_RATE)
+#define SOAK_SETTLE_TICKS (5 * GAME_TICK_RATE) // time for hits in flight at the end to land
+
+
+typedef struct soak_stats_s Soak_Stats;
+
+
+struct soak_stats_s
+{
+    pthread_t thread;
+    uint32_t matches;
+    uint32_t timeouts; // matches that ran out of time
+    uint64_t ticks;
+    uint32_t score_mismatches;
+    uint32_t split_episodes; // one board on the score screen, the other playing
+    uint32_t stuck_episodes; // both boards on the score screen
+    uint64_t frames_ok;
+    uint64_t frames_bad;
+    uint64_t frames_lost;
+    uint64_t sent;
+    uint64_t dropped;
+    uint64_t corrupted;
+    uint64_t overflowed;
+    uint64_t delivered;
+};
+
+
+static Ir_Link_Config link_config = {5, 20, 0.01, 0.01};
+
+
+static uint32_t num_matches = SOAK_MATCHES;
+
+
+static atomic_uint next_match;
+
+
+/**
+ * Returns a monotonic time in ns.
+ * @return The time in ns
+ */
+static uint64_t soak_now (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+
+/**
+ * Returns whether the two boards of a match disagree on the score.
+ * @param match - A pointer to the match
+ * @return 1 if they disagree, 0 otherwise
+ */
+static uint8_t soak_scores_differ (const Match* match)
+{
+    return match->games[0].own_score != match->games[1].enemy_score
+        || match->games[0].enemy_score != match->games[1].own_score;
+}
+
+
+/**
+ * Plays one match over a pair of bad links and adds up how it went.
+ * @param number - The number of the match, picks its bots and seeds it
+ * @param stats - The stats to add to
+ */
+static void soak_match (uint32_t number, Soak_Stats* stats)
+{
+    Match match;
+    Ir_Link links[2];
+    uint32_t split_ticks = 0;
+    uint32_t stuck_ticks = 0;
+    uint32_t settle_ticks;
+    uint8_t i;
+
+    match_init (&match, &bot_policies[number % bot_num_policies],
+                &bot_policies[number / bot_num_policies % bot_num_policies], number);
+    ir_link_init (&links[0], &link_config, 2 * number);
+    ir_link_init (&links[1], &link_config, 2 * number + 1);
+    ir_link_connect (&match.kits[0], &match.kits[1], &links[0], &links[1]);
+
+    while (!match_over (&match)) {
+        uint8_t on_score = (match.games[0].state == STATE_SCORE) + (match.games[1].state == STATE_SCORE);
+
+        match_tick (&match);
+
+        split_ticks = on_score == 1 ? split_ticks + 1 : 0;
+        stuck_ticks = on_score == 2 ? stuck_ticks + 1 : 0;
+        stats->split_episodes += split_ticks == SOAK_STUCK_TICKS;
+        stats->stuck_episodes += stuck_ticks == SOAK_STUCK_TICKS;
+    }
+
+    stats->matches++;
+    stats->timeouts += match.ticks >= MATCH_MAX_TICKS;
+
+    /* The match ends on the first board's score, so the hit that ended it
+     * may still be crossing to the second board. */
+    for (settle_ticks = 0; soak_scores_differ (&match) && settle_ticks < SOAK_SETTLE_TICKS; settle_ticks++) {
+        match_tick (&match);
+    }
+
+    stats->ticks += match.ticks;
+    stats->score_mismatches += soak_scores_differ (&match);
+
+    for (i = 0; i < 2; i++) {
+        stats->frames_ok += match.games[i].rx.frames_ok;
+        stats->frames_bad += match.games[i].rx.frames_bad;
+        stats->frames_lost += match.games[i].rx.frames_lost;
+        stats->sent += links[i].sent;
+        stats->dropped += links[i].dropped;
+        stats->corrupted += links[i].corrupted;
+        stats->overflowed += links[i].overflowed;
+        stats->delivered += links[i].delivered;
+    }
+}
+
+
+/**
+ * Plays matches until every match has been handed out.
+ * @param arg - The thread's stats
+ * @return NULL
+ */
+static void* soak_run (void* arg)
+{
+    uint32_t number;
+
+    while ((number = atomic_fetch_add (&next_match, 1)) < num_matches) {
+        soak_match (number, arg);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Runs the soak. The arguments are optional: the number of matches and
+ * of threads, the chances of a byte being dropped and corrupted, and the
+ * latency and jitter of the link in ms.
+ */
+int main (int argc, char** argv)
+{
+    uint16_t num_threads = sysconf (_SC_NPROCESSORS_ONLN);
+    Soak_Stats* stats;
+    Soak_Stats total = {0};
+    uint64_t start;
+    double elapsed;
+    uint16_t started;
+    uint16_t i;
+
+    if (argc > 1 && strtoul (argv[1], NULL, 0) > 0) {
+        num_matches = strtoul (argv[1], NULL, 0);
+    }
+    if (argc > 2 && strtoul (argv[2], NULL, 0) > 0) {
+        num_threads = strtoul (argv[2], NULL, 0);
+    }
+    if (argc > 3) {
+        link_config.drop = atof (argv[3]);
+    }
+    if (argc > 4) {
+        link_config.corrupt = atof (argv[4]);
+    }
+    if (argc > 5) {
+        link_config.latency_ms = atof (argv[5]);
+    }
+    if (argc > 6) {
+        link_config.jitter_ms = atof (argv[6]);
+    }
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+
+    stats = calloc (num_threads, sizeof (*stats));
+    if (stats == NULL) {
+        fprintf (stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    printf ("%lu matches on %u threads, drop %g, corrupt %g, latency %g ms, jitter %g ms\n",
+            (unsigned long) num_matches, num_threads, link_config.drop, link_config.corrupt,
+            link_config.latency_ms, link_config.jitter_ms);
+
+    start = soak_now ();
+
+    for (i = 0; i < num_threads; i++) {
+        if (pthread_create (&stats[i].thread, NULL, soak_run, &stats[i]) != 0) {
+            break;
+        }
+    }
+    started = i;
+    if (started < num_threads) {
+        fprintf (stderr, "%s: cannot start thread %u\n", argv[0], started);
+        /* Hand out no more matches, so the threads already running stop
+         * after their current one. */
+        atomic_store (&next_match, num_matches);
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join (stats[i].thread, NULL);
+
+        total.matches += stats[i].matches;
+        total.timeouts += stats[i].timeouts;
+        total.ticks += stats[i].ticks;
+        total.score_mismatches += stats[i].score_mismatches;
+        total.split_episodes += stats[i].split_episodes;
+        total.stuck_episodes += stats[i].stuck_episodes;
+        total.frames_ok += stats[i].frames_ok;
+        total.frames_bad += stats[i].frames_bad;
+        total.frames_lost += stats[i].frames_lost;
+        total.sent += stats[i].sent;
+        total.dropped += stats[i].dropped;
+        total.corrupted += stats[i].corrupted;
+        total.overflowed += stats[i].overflowed;
+        total.delivered += stats[i].delivered;
+    }
+
+    elapsed = (soak_now () - start) / 1e9;
+
+    if (started < num_threads) {
+        free (stats);
+        return 1;
+    }
+
+    printf ("%lu matches in %.2f s, %.1f matches/s, %.0f game s per s, %lu ran out of time\n",
+            (unsigned long) total.matches, elapsed, total.matches / elapsed,
+            (double) total.ticks / GAME_TICK_RATE / elapsed, (unsigned long) total.timeouts);
+    printf ("link: sent %llu, dropped %llu, corrupted %llu, overflowed %llu, delivered %llu\n",
+            (unsigned long long) total.sent, (unsigned long long) total.dropped,
+            (unsigned long long) total.corrupted, (unsigned long long) total.overflowed,
+            (unsigned long long) total.delivered);
+    printf ("frames: ok %llu, bad %llu, lost %llu\n", (unsigned long long) total.frames_ok,
+            (unsigned long long) total.frames_bad, (unsigned long long) total.frames_lost);
+    printf ("desyncs: scores disagree in %lu matches, one board on the score screen for over %u s %lu times,"
+            " both for over %u s %lu times\n",
+            (unsigned long) total.score_mismatches, SOAK_STUCK_TICKS / GAME_TICK_RATE,
+            (unsigned long) total.split_episodes, SOAK_STUCK_TICKS / GAME_TICK_RATE,
+            (unsigned long) total.stuck_episodes);
+
+    free (stats);
+    return total.score_mismatches ? 1 : 0;
+}
@@ -0,0 +1,366 @@
+/** @file tournament.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 14 Nov 19
+ *  @brief Plays every pairing of bot policies against each other many
+ *  times and prints how the matches ended, for tuning the game's rates.
+ *
+ *  Matches are shared out over worker threads. Each worker starts with an
+ *  even share of the matches and plays them from the front, and a worker
+ *  that runs out steals the back half of another worker's share, so long
+ *  matches do not leave threads idle. Each match is seeded by its number,
+ *  so the results do not depend on the number of threads.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "system.h"
+#include "game_sim.h"
+#include "match.h"
+
+
+#define TOURNAMENT_MATCHES 100 // matches per pairing
+
+
+typedef struct pairing_s Pairing;
+
+
+typedef struct match_result_s Match_Result;
+
+
+typedef struct worker_s Worker;
+
+
+struct pairing_s
+{
+    const Bot_Policy* a;
+    const Bot_Policy* b;
+};
+
+
+struct match_result_s
+{
+    uint8_t a_score;
+    uint8_t b_score;
+    uint32_t ticks;
+};
+
+
+/* A worker's share of the matches is next up to end. Thieves take from
+ * the end, the worker from next. */
+struct worker_s
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    uint32_t next;
+    uint32_t end;
+    uint32_t played;
+    uint32_t stolen; // matches taken from other workers
+};
+
+
+static Pairing* pairings;
+
+
+static uint32_t num_pairings;
+
+
+static uint32_t matches_per_pairing = TOURNAMENT_MATCHES;
+
+
+static Match_Result* results;
+
+
+static Worker* workers;
+
+
+static uint16_t num_workers;
+
+
+/**
+ * Returns a monotonic time in ns.
+ * @return The time in ns
+ */
+static uint64_t tournament_now (void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+
+/**
+ * Takes the next match from a worker's own share.
+ * @param worker - The worker
+ * @param job - Set to the number of the match
+ * @return 1 if a match was taken, 0 if the share is empty
+ */
+static uint8_t worker_take (Worker* worker, uint32_t* job)
+{
+    uint8_t taken = 0;
+
+    pthread_mutex_lock (&worker->lock);
+    if (worker->next < worker->end) {
+        *job = worker->next++;
+        taken = 1;
+    }
+    pthread_mutex_unlock (&worker->lock);
+
+    return taken;
+}
+
+
+/**
+ * Steals the back half of the first other worker's share that has any
+ * matches left and makes it the thief's share.
+ * @param thief - The worker that ran out
+ * @return 1 if matches were stolen, 0 if every share is empty
+ */
+static uint8_t worker_steal (Worker* thief)
+{
+    uint16_t self = thief - workers;
+    uint16_t i;
+
+    for (i = 1; i < num_workers; i++) {
+        Worker* victim = &workers[(self + i) % num_workers];
+        uint32_t start = 0;
+        uint32_t end = 0;
+
+        pthread_mutex_lock (&victim->lock);
+        if (victim->next < victim->end) {
+            end = victim->end;
+            start = end - (end - victim->next + 1) / 2;
+            victim->end = start;
+        }
+        pthread_mutex_unlock (&victim->lock);
+
+        if (start < end) {
+            pthread_mutex_lock (&thief->lock);
+            thief->next = start;
+            thief->end = end;
+            thief->stolen += end - start;
+            pthread_mutex_unlock (&thief->lock);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * Plays matches until there are none left to take or steal.
+ * @param arg - The worker
+ * @return NULL
+ */
+static void* worker_run (void* arg)
+{
+    Worker* worker = arg;
+    Match match;
+    uint32_t job;
+
+    do {
+        while (worker_take (worker, &job)) {
+            const Pairing* pairing = &pairings[job / matches_per_pairing];
+
+            match_init (&match, pairing->a, pairing->b, job);
+            match_play (&match);
+
+            results[job].a_score = match.games[0].own_score;
+            results[job].b_score = match.games[0].enemy_score;
+            results[job].ticks = match.ticks;
+            worker->played++;
+        }
+    } while (worker_steal (worker));
+
+    return NULL;
+}
+
+
+/**
+ * Prints the wins, match length and score lines of one pairing.
+ * @param pairing - The pairing
+ * @param first - The results of its matches
+ */
+static void print_pairing (const Pairing* pairing, const Match_Result* first)
+{
+    uint32_t lines[MATCH_POINTS + 1][MATCH_POINTS + 1] = {{0}};
+    uint32_t a_wins = 0;
+    uint32_t b_wins = 0;
+    uint64_t ticks = 0;
+    uint32_t i;
+    uint8_t a;
+    uint8_t b;
+
+    for (i = 0; i < matches_per_pairing; i++) {
+        const Match_Result* result = &first[i];
+
+        a = result->a_score < MATCH_POINTS ? result->a_score : MATCH_POINTS;
+        b = result->b_score < MATCH_POINTS ? result->b_score : MATCH_POINTS;
+        lines[a][b]++;
+        a_wins += a == MATCH_POINTS && b < MATCH_POINTS;
+        b_wins += b == MATCH_POINTS && a < MATCH_POINTS;
+        ticks += result->ticks;
+    }
+
+    printf ("%-8s v %-8s %6lu-%-6lu drawn %5lu  %7.1f s/match\n", pairing->a->name, pairing->b->name,
+            (unsigned long) a_wins, (unsigned long) b_wins,
+            (unsigned long) (matches_per_pairing - a_wins - b_wins),
+            (double) ticks / matches_per_pairing / GAME_TICK_RATE);
+
+    printf ("   ");
+    for (a = 0; a <= MATCH_POINTS; a++) {
+        for (b = 0; b <= MATCH_POINTS; b++) {
+            if (lines[a][b]) {
+                printf (" %u-%u:%lu", a, b, (unsigned long) lines[a][b]);
+            }
+        }
+    }
+    printf ("\n");
+}
+
+
+/**
+ * Runs the tournament. The arguments are an optional number of matches
+ * per pairing and of threads, then the policies to play, all of them by
+ * default. Every policy plays every other and itself.
+ */
+int main (int argc, char** argv)
+{
+    const Bot_Policy** policies = calloc (argc + bot_num_policies, sizeof (*policies));
+    uint16_t num_policies = 0;
+    uint32_t total;
+    uint32_t share;
+    uint32_t started;
+    uint64_t ticks = 0;
+    uint64_t start;
+    double elapsed;
+    uint32_t i;
+    uint32_t j;
+    int arg;
+
+    if (policies == NULL) {
+        fprintf (stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    num_workers = sysconf (_SC_NPROCESSORS_ONLN);
+
+    if (argc > 1 && strtoul (argv[1], NULL, 0) > 0) {
+        matches_per_pairing = strtoul (argv[1], NULL, 0);
+    }
+    if (argc > 2 && strtoul (argv[2], NULL, 0) > 0) {
+        num_workers = strtoul (argv[2], NULL, 0);
+    }
+    if (num_workers == 0) {
+        num_workers = 1;
+    }
+
+    for (arg = 3; arg < argc; arg++) {
+        policies[num_policies] = bot_find (argv[arg]);
+        if (policies[num_policies] == NULL) {
+            fprintf (stderr, "%s: no policy %s\n", argv[0], argv[arg]);
+            return 1;
+        }
+        num_policies++;
+    }
+    if (num_policies == 0) {
+        for (i = 0; i < bot_num_policies; i++) {
+            policies[num_policies++] = &bot_policies[i];
+        }
+    }
+
+    pairings = calloc (num_policies * (num_policies + 1) / 2, sizeof (*pairings));
+    if (pairings == NULL) {
+        fprintf (stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < num_policies; i++) {
+        for (j = i; j < num_policies; j++) {
+            pairings[num_pairings].a = policies[i];
+            pairings[num_pairings].b = policies[j];
+            num_pairings++;
+        }
+    }
+
+    total = num_pairings * matches_per_pairing;
+    share = (total + num_workers - 1) / num_workers;
+    results = calloc (total, sizeof (*results));
+    workers = calloc (num_workers, sizeof (*workers));
+
+    if (results == NULL || workers == NULL) {
+        fprintf (stderr, "%s: out of memory\n", argv[0]);
+        return 1;
+    }
+
+    printf ("%lu pairings x %lu matches on %u threads, first to %u points\n", (unsigned long) num_pairings,
+            (unsigned long) matches_per_pairing, num_workers, MATCH_POINTS);
+
+    start = tournament_now ();
+
+    for (i = 0; i < num_workers; i++) {
+        pthread_mutex_init (&workers[i].lock, NULL);
+        workers[i].next = i * share < total ? i * share : total;
+        workers[i].end = (i + 1) * share < total ? (i + 1) * share : total;
+    }
+    for (i = 0; i < num_workers; i++) {
+        if (pthread_create (&workers[i].thread, NULL, worker_run, &workers[i]) != 0) {
+            break;
+        }
+    }
+    started = i;
+    if (started < num_workers) {
+        fprintf (stderr, "%s: cannot start thread %lu\n", argv[0], (unsigned long) started);
+        /* Empty every share so the threads already running stop after
+         * their current match. */
+        for (i = 0; i < num_workers; i++) {
+            pthread_mutex_lock (&workers[i].lock);
+            workers[i].end = workers[i].next;
+            pthread_mutex_unlock (&workers[i].lock);
+        }
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join (workers[i].thread, NULL);
+    }
+    if (started < num_workers) {
+        for (i = 0; i < num_workers; i++) {
+            pthread_mutex_destroy (&workers[i].lock);
+        }
+        free (workers);
+        free (results);
+        free (pairings);
+        free (policies);
+        return 1;
+    }
+
+    elapsed = (tournament_now () - start) / 1e9;
+
+    for (i = 0; i < num_pairings; i++) {
+        print_pairing (&pairings[i], &results[i * matches_per_pairing]);
+    }
+
+    for (i = 0; i < total; i++) {
+        ticks += results[i].ticks;
+    }
+
+    printf ("%lu matches in %.2f s, %.1f matches/s, %.0f game s per s\n", (unsigned long) total,
+            elapsed, total / elapsed, (double) ticks / GAME_TICK_RATE / elapsed);
+
+    for (i = 0; i < num_workers; i++) {
+        printf ("thread %lu played %lu, stole %lu\n", (unsigned long) i, (unsigned long) workers[i].played,
+                (unsigned long) workers[i].stolen);
+        pthread_mutex_destroy (&workers[i].lock);
+    }
+
+    free (workers);
+    free (results);
+    free (pairings);
+    free (policies);
+    return 0;
+}
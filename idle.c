@@ -0,0 +1,81 @@
+/** @file idle.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 10 Nov 19
+ *  @brief Waits for a deadline with the MCU asleep.
+ */
+
+
+#include "system.h"
+#include "timer.h"
+#include "idle.h"
+
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#else
+#include "funkit.h"
+#endif
+
+
+#ifdef __AVR__
+/**
+ * Compare match interrupt. Only there to wake the CPU.
+ */
+EMPTY_INTERRUPT (TIMER1_COMPA_vect);
+#endif
+
+
+/**
+ * Starts the timer and sets up the compare match used to wake the CPU.
+ */
+void idle_init (void)
+{
+    timer_init ();
+
+#ifdef __AVR__
+#ifdef PROFILE
+    TCCR1B = (TCCR1B & ~(BIT (CS12) | BIT (CS11) | BIT (CS10))) | BIT (CS10);
+#endif
+    TIMSK1 |= BIT (OCIE1A);
+    set_sleep_mode (SLEEP_MODE_IDLE);
+    sei ();
+#endif
+}
+
+
+/**
+ * Sleeps until a time. Returns at once if the time has already passed.
+ * @param when - The time to wake in timer ticks
+ * @return 1 to carry on running. A host returns 0 once the simulated
+ * funkit has run for FUNKIT_SECONDS.
+ */
+uint8_t idle_until (timer_tick_t when)
+{
+#ifdef __AVR__
+    OCR1A = when;
+
+    /* Interrupts are off between the check and the sleep, since sei only
+     * takes effect after the next instruction a compare match cannot slip
+     * in between and leave us asleep until the timer wraps. */
+    while (1) {
+        cli ();
+        if ((timer_tick_t) (timer_get () - when) < 0x8000) {
+            break;
+        }
+        sleep_enable ();
+        sei ();
+        sleep_cpu ();
+        sleep_disable ();
+    }
+    sei ();
+
+    return 1;
+#else
+    if ((timer_tick_t) (when - timer_get ()) < 0x8000) {
+        timer_wait_until (when);
+    }
+
+    return funkit_running (funkit_current);
+#endif
+}
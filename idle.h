@@ -0,0 +1,48 @@
+/** @file idle.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 10 Nov 19
+ *  @brief Waits for a deadline with the MCU asleep. On the funkit the CPU
+ *  is put in idle sleep and woken by a timer1 compare match at the
+ *  deadline, or earlier by any other interrupt such as received IR.
+ *
+ *  A PROFILE build on the funkit runs timer1 straight off the CPU clock,
+ *  so profile times are in cycles. A game tick is then 16000 timer ticks,
+ *  still within the half of the 16 bit timer that idle_until compares
+ *  over, but the timer wraps every 8 ms so it can not also time LATENCY.
+ */
+
+
+#ifndef IDLE_H
+#define IDLE_H
+
+
+#include "system.h"
+#include "timer.h"
+
+
+#if defined (PROFILE) && defined (__AVR__)
+#ifdef LATENCY
+#error "PROFILE and LATENCY can not share timer1 on the funkit"
+#endif
+#define IDLE_TIMER_RATE F_CPU
+#else
+#define IDLE_TIMER_RATE TIMER_RATE
+#endif
+
+
+/**
+ * Starts the timer and sets up the compare match used to wake the CPU.
+ */
+void idle_init (void);
+
+
+/**
+ * Sleeps until a time. Returns at once if the time has already passed.
+ * @param when - The time to wake in timer ticks
+ * @return 1 to carry on running. A host returns 0 once the simulated
+ * funkit has run for FUNKIT_SECONDS.
+ */
+uint8_t idle_until (timer_tick_t when);
+
+
+#endif
@@ -0,0 +1,228 @@
+/** @file latency.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 17 Nov 19
+ *  @brief Input-to-photon latency of the ship.
+ */
+
+
+#include "system.h"
+#include "tinygl.h"
+#include "geometry.h"
+#include "latency.h"
+
+#ifdef __AVR__
+#include "ir_uart.h"
+#include "dump.h"
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+
+typedef enum latency_state {LATENCY_IDLE, LATENCY_PRESSED, LATENCY_MOVED} latency_state_t;
+
+
+static const char* const latency_names[LATENCY_NUM] = {"edge-move", "move-photon", "edge-photon"};
+
+
+static Latency_Stat latency_stats[LATENCY_NUM];
+
+
+static uint32_t latency_histogram[LATENCY_BUCKETS];
+
+
+static timer_tick_t latency_bucket_width;
+
+
+static latency_state_t latency_state;
+
+
+static timer_tick_t latency_edge_time;
+
+
+static timer_tick_t latency_move_time;
+
+
+static uint8_t latency_scan_col; // the column the next refresh drives
+
+
+/**
+ * Adds one time to a stage's counters.
+ * @param id - The stage
+ * @param elapsed - The time in timer ticks
+ */
+static void latency_record (latency_id_t id, timer_tick_t elapsed)
+{
+    Latency_Stat* stat = &latency_stats[id];
+
+    stat->count++;
+    stat->total += elapsed;
+
+    if (elapsed < stat->min) {
+        stat->min = elapsed;
+    }
+
+    if (elapsed > stat->max) {
+        stat->max = elapsed;
+    }
+}
+
+
+/**
+ * Resets the counters and the histogram. On a host they are also printed
+ * at exit.
+ * @param tick_rate - The game tick rate in Hz, each histogram bucket is
+ * one game tick wide
+ */
+void latency_init (uint16_t tick_rate)
+{
+    uint8_t i;
+
+    for (i = 0; i < LATENCY_NUM; i++) {
+        latency_stats[i].count = 0;
+        latency_stats[i].total = 0;
+        latency_stats[i].min = (timer_tick_t) -1;
+        latency_stats[i].max = 0;
+    }
+
+    for (i = 0; i < LATENCY_BUCKETS; i++) {
+        latency_histogram[i] = 0;
+    }
+
+    latency_bucket_width = TIMER_RATE / tick_rate;
+    latency_state = LATENCY_IDLE;
+
+#ifndef __AVR__
+    atexit (latency_dump);
+#endif
+}
+
+
+/**
+ * Stamps a north or south press seen by a navswitch poll. Ignored while
+ * the last move is still waiting for the display.
+ */
+void latency_press (void)
+{
+    if (latency_state != LATENCY_MOVED) {
+        latency_edge_time = timer_get ();
+        latency_state = LATENCY_PRESSED;
+    }
+}
+
+
+/**
+ * Stamps the ship_move_* call that follows a press, or drops the press
+ * if the ship could not move.
+ * @param moved - 1 if the ship's row changed
+ */
+void latency_move (uint8_t moved)
+{
+    if (latency_state != LATENCY_PRESSED) {
+        return;
+    }
+
+    if (moved) {
+        latency_move_time = timer_get ();
+        latency_state = LATENCY_MOVED;
+    } else {
+        latency_state = LATENCY_IDLE;
+    }
+}
+
+
+/**
+ * Counts a display refresh, and completes a sample if it is the first to
+ * light the ship's column since the ship moved. Called after every
+ * tinygl_update.
+ */
+void latency_refresh (void)
+{
+    uint8_t col = latency_scan_col;
+    timer_tick_t now;
+    timer_tick_t total;
+    uint16_t bucket;
+
+    latency_scan_col = col + 1 < TINYGL_WIDTH ? col + 1 : 0;
+
+    if (latency_state != LATENCY_MOVED || col != BOT_OF_MATRIX) {
+        return;
+    }
+
+    now = timer_get ();
+    total = now - latency_edge_time;
+
+    latency_record (LATENCY_EDGE_TO_MOVE, latency_move_time - latency_edge_time);
+    latency_record (LATENCY_MOVE_TO_PHOTON, now - latency_move_time);
+    latency_record (LATENCY_EDGE_TO_PHOTON, total);
+
+    bucket = total / latency_bucket_width;
+    if (bucket >= LATENCY_BUCKETS) {
+        bucket = LATENCY_BUCKETS - 1;
+    }
+    latency_histogram[bucket]++;
+
+    latency_state = LATENCY_IDLE;
+}
+
+
+/**
+ * Returns the counters for a stage.
+ * @param id - The stage
+ * @return A pointer to the counters
+ */
+const Latency_Stat* latency_stat (latency_id_t id)
+{
+    return &latency_stats[id];
+}
+
+
+/**
+ * Writes a line per stage with its sample count and min, max and mean
+ * time, then a line per histogram bucket of the total time. Goes over the
+ * IR UART on the funkit and to stderr on a host.
+ */
+void latency_dump (void)
+{
+    uint8_t i;
+
+    for (i = 0; i < LATENCY_NUM; i++) {
+        const Latency_Stat* stat = &latency_stats[i];
+        timer_tick_t min = stat->count ? stat->min : 0;
+        uint32_t mean = stat->count ? stat->total / stat->count : 0;
+
+#ifdef __AVR__
+        ir_uart_puts (latency_names[i]);
+        ir_uart_putc (' ');
+        dump_u32 (stat->count);
+        ir_uart_putc (' ');
+        dump_u32 (min);
+        ir_uart_putc (' ');
+        dump_u32 (stat->max);
+        ir_uart_putc (' ');
+        dump_u32 (mean);
+        ir_uart_putc ('\n');
+#else
+        fprintf (stderr, "%-11s samples %6lu  min %6.2f ms  max %6.2f ms  mean %6.2f ms\n",
+                 latency_names[i], (unsigned long) stat->count, min * 1000.0 / TIMER_RATE,
+                 stat->max * 1000.0 / TIMER_RATE, mean * 1000.0 / TIMER_RATE);
+#endif
+    }
+
+    /* Each bucket is printed with its upper bound, the last with its lower. */
+    for (i = 0; i < LATENCY_BUCKETS; i++) {
+        uint8_t last = i == LATENCY_BUCKETS - 1;
+        uint32_t bound = (uint32_t) (last ? i : i + 1) * latency_bucket_width;
+
+#ifdef __AVR__
+        ir_uart_putc (last ? '>' : '<');
+        dump_u32 (bound);
+        ir_uart_putc (' ');
+        dump_u32 (latency_histogram[i]);
+        ir_uart_putc ('\n');
+#else
+        fprintf (stderr, "%-2s %6.2f ms %6lu\n", last ? ">=" : "<", bound * 1000.0 / TIMER_RATE,
+                 (unsigned long) latency_histogram[i]);
+#endif
+    }
+}
@@ -0,0 +1,118 @@
+/** @file latency.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 17 Nov 19
+ *  @brief Input-to-photon latency of the ship. Built in only when LATENCY
+ *  is defined, otherwise the macros compile to nothing.
+ *
+ *  Each ship move is timed at three points: the navswitch poll that saw
+ *  the press, the ship_move_* call that changed the ship's row, and the
+ *  first display refresh after that which lights the ship's column.
+ *  tinygl drives one column per update, in order from column 0, so the
+ *  column on a refresh is the refresh count modulo TINYGL_WIDTH. The time
+ *  from the press to the poll that sees it, up to INPUT_PERIOD plus the
+ *  navswitch debounce, comes before the first timestamp and is not seen.
+ *
+ *  Times are timer ticks (128 us) on the funkit and on a host, where they
+ *  follow the simulated clock.
+ */
+
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+
+#include "system.h"
+#include "timer.h"
+
+
+#define LATENCY_BUCKETS 16 // the last bucket also holds everything longer
+
+
+typedef enum latency_id {LATENCY_EDGE_TO_MOVE, LATENCY_MOVE_TO_PHOTON, LATENCY_EDGE_TO_PHOTON,
+                         LATENCY_NUM} latency_id_t;
+
+
+typedef struct latency_stat_s Latency_Stat;
+
+
+struct latency_stat_s
+{
+    uint32_t count;
+    uint32_t total;
+    timer_tick_t min;
+    timer_tick_t max;
+};
+
+
+#ifdef LATENCY
+#define LATENCY_INIT(tick_rate) latency_init (tick_rate)
+#define LATENCY_PRESS() latency_press ()
+#define LATENCY_MOVE_START(y) tinygl_coord_t latency_move_from = (y)
+#define LATENCY_MOVE_STOP(y) latency_move ((y) != latency_move_from)
+#define LATENCY_REFRESH() latency_refresh ()
+#else
+#define LATENCY_INIT(tick_rate)
+#define LATENCY_PRESS()
+#define LATENCY_MOVE_START(y)
+#define LATENCY_MOVE_STOP(y)
+#define LATENCY_REFRESH()
+#endif
+
+
+/* Dumps on request on the funkit. A host dumps once at exit instead. */
+#if defined (LATENCY) && defined (__AVR__)
+#define LATENCY_DUMP() latency_dump ()
+#else
+#define LATENCY_DUMP()
+#endif
+
+
+/**
+ * Resets the counters and the histogram. On a host they are also printed
+ * at exit.
+ * @param tick_rate - The game tick rate in Hz, each histogram bucket is
+ * one game tick wide
+ */
+void latency_init (uint16_t tick_rate);
+
+
+/**
+ * Stamps a north or south press seen by a navswitch poll. Ignored while
+ * the last move is still waiting for the display.
+ */
+void latency_press (void);
+
+
+/**
+ * Stamps the ship_move_* call that follows a press, or drops the press
+ * if the ship could not move.
+ * @param moved - 1 if the ship's row changed
+ */
+void latency_move (uint8_t moved);
+
+
+/**
+ * Counts a display refresh, and completes a sample if it is the first to
+ * light the ship's column since the ship moved. Called after every
+ * tinygl_update.
+ */
+void latency_refresh (void);
+
+
+/**
+ * Returns the counters for a stage.
+ * @param id - The stage
+ * @return A pointer to the counters
+ */
+const Latency_Stat* latency_stat (latency_id_t id);
+
+
+/**
+ * Writes a line per stage with its sample count and min, max and mean
+ * time, then a line per histogram bucket of the total time. Goes over the
+ * IR UART on the funkit and to stderr on a host.
+ */
+void latency_dump (void);
+
+
+#endif
@@ -0,0 +1,181 @@
+/** @file packet.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 4 Nov 19
+ *  @brief The IR wire protocol between the two funkits.
+ */
+
+
+#include "system.h"
+#include "ir_uart.h"
+#include "packet.h"
+
+
+typedef enum rx_state {RX_SYNC, RX_HEADER, RX_STAMP, RX_EVENTS, RX_CRC} rx_state_t;
+
+
+/**
+ * Adds a byte to a CRC-8 (polynomial 0x07).
+ * @param crc - The CRC so far
+ * @param byte - The byte to add
+ * @return The new CRC
+ */
+static uint8_t crc8_update (uint8_t crc, uint8_t byte)
+{
+    uint8_t i;
+
+    crc ^= byte;
+
+    for (i = 0; i < 8; i++) {
+        crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+
+    return crc;
+}
+
+
+/**
+ * Empties the transmit queue.
+ * @param tx - A pointer to the transmit queue
+ */
+void packet_tx_init (Packet_Tx* tx)
+{
+    tx->count = 0;
+    tx->seq = 0;
+    tx->stamp = 0;
+}
+
+
+/**
+ * Resets the receiver.
+ * @param rx - A pointer to the receiver
+ */
+void packet_rx_init (Packet_Rx* rx)
+{
+    rx->state = RX_SYNC;
+    rx->header = 0;
+    rx->stamp = 0;
+    rx->len = 0;
+    rx->crc = 0;
+    rx->synced = 0;
+    rx->next_seq = 0;
+    rx->frames_ok = 0;
+    rx->frames_bad = 0;
+    rx->frames_lost = 0;
+}
+
+
+/**
+ * Queues an event to be sent in the next frame. Sends the current frame
+ * first if it is full.
+ * @param tx - A pointer to the transmit queue
+ * @param event - The event byte
+ */
+void packet_queue (Packet_Tx* tx, uint8_t event)
+{
+    if (tx->count == PACKET_MAX_EVENTS) {
+        packet_flush (tx);
+    }
+
+    tx->events[tx->count++] = event;
+}
+
+
+/**
+ * Sends the queued events as one frame. Does nothing if none are queued.
+ * @param tx - A pointer to the transmit queue
+ */
+void packet_flush (Packet_Tx* tx)
+{
+    uint8_t header = (tx->seq << 4) | tx->count;
+    uint8_t crc = crc8_update (crc8_update (0, header), tx->stamp);
+    uint8_t i;
+
+    if (tx->count == 0) {
+        return;
+    }
+
+    ir_uart_putc (PACKET_SYNC);
+    ir_uart_putc (header);
+    ir_uart_putc (tx->stamp);
+
+    for (i = 0; i < tx->count; i++) {
+        ir_uart_putc (tx->events[i]);
+        crc = crc8_update (crc, tx->events[i]);
+    }
+
+    ir_uart_putc (crc);
+
+    tx->count = 0;
+    tx->seq = (tx->seq + 1) & PACKET_SEQ_MASK;
+}
+
+
+/**
+ * Feeds a received byte to the receiver.
+ * @param rx - A pointer to the receiver
+ * @param byte - The received byte
+ * @return The number of events in rx->events when the byte completes a
+ * valid frame, 0 otherwise
+ */
+uint8_t packet_rx_byte (Packet_Rx* rx, uint8_t byte)
+{
+    uint8_t count = rx->header & PACKET_SEQ_MASK;
+    uint8_t seq = rx->header >> 4;
+
+    switch (rx->state) {
+        case RX_SYNC:
+            if (byte == PACKET_SYNC) {
+                rx->state = RX_HEADER;
+            }
+            break;
+
+        case RX_HEADER:
+            count = byte & PACKET_SEQ_MASK;
+
+            if (count == 0 || count > PACKET_MAX_EVENTS) {
+                rx->frames_bad++;
+                rx->state = byte == PACKET_SYNC ? RX_HEADER : RX_SYNC;
+                break;
+            }
+
+            rx->header = byte;
+            rx->crc = crc8_update (0, byte);
+            rx->len = 0;
+            rx->state = RX_STAMP;
+            break;
+
+        case RX_STAMP:
+            rx->stamp = byte;
+            rx->crc = crc8_update (rx->crc, byte);
+            rx->state = RX_EVENTS;
+            break;
+
+        case RX_EVENTS:
+            rx->events[rx->len++] = byte;
+            rx->crc = crc8_update (rx->crc, byte);
+
+            if (rx->len == count) {
+                rx->state = RX_CRC;
+            }
+            break;
+
+        case RX_CRC:
+            rx->state = RX_SYNC;
+
+            if (byte != rx->crc) {
+                rx->frames_bad++;
+                break;
+            }
+
+            if (rx->synced) {
+                rx->frames_lost += (seq - rx->next_seq) & PACKET_SEQ_MASK;
+            }
+
+            rx->synced = 1;
+            rx->next_seq = (seq + 1) & PACKET_SEQ_MASK;
+            rx->frames_ok++;
+            return count;
+    }
+
+    return 0;
+}
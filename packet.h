@@ -0,0 +1,105 @@
+/** @file packet.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 4 Nov 19
+ *  @brief The IR wire protocol between the two funkits. Events (bullets
+ *  crossing over and round control) are batched into framed packets:
+ *
+ *      SYNC | seq << 4 | count | stamp | count event bytes | CRC-8
+ *
+ *  The sequence number lets the receiver count lost frames and the CRC
+ *  lets it drop corrupted ones instead of acting on them. The stamp is the
+ *  sender's game clock when the frame was sent, see game_clock_stamp.
+ */
+
+
+#ifndef PACKET_H
+#define PACKET_H
+
+
+#include "system.h"
+
+
+#define PACKET_SYNC 0x7E
+#define PACKET_MAX_EVENTS 8
+#define PACKET_SEQ_MASK 0x0F
+
+
+#define PACKET_EVENT_BULLET 0x80 // 1 0 dd cccc: bullet in column c with direction d
+#define PACKET_EVENT_CONTROL 0x40 // 0 1 xxxxxx: control event x
+#define PACKET_EVENT_HITS 0x00 // 0 0 hhhhhh: the sender has been hit h times, modulo 64
+#define PACKET_COLUMN_MASK 0x0F // the column c of a bullet event
+#define PACKET_HITS_MASK 0x3F // the count h of a hits event
+
+
+typedef struct packet_tx_s Packet_Tx;
+
+
+typedef struct packet_rx_s Packet_Rx;
+
+
+struct packet_tx_s
+{
+    uint8_t events[PACKET_MAX_EVENTS];
+    uint8_t count;
+    uint8_t seq;
+    uint8_t stamp; // clock stamp sent with the next frame
+};
+
+
+struct packet_rx_s
+{
+    uint8_t state;
+    uint8_t header;
+    uint8_t stamp; // clock stamp of the frame
+    uint8_t events[PACKET_MAX_EVENTS];
+    uint8_t len;
+    uint8_t crc;
+    uint8_t next_seq;
+    uint8_t synced; // whether a frame has been received yet
+    uint16_t frames_ok;
+    uint16_t frames_bad; // dropped for a bad header or checksum
+    uint16_t frames_lost; // missing going by the sequence numbers
+};
+
+
+/**
+ * Empties the transmit queue.
+ * @param tx - A pointer to the transmit queue
+ */
+void packet_tx_init (Packet_Tx* tx);
+
+
+/**
+ * Resets the receiver.
+ * @param rx - A pointer to the receiver
+ */
+void packet_rx_init (Packet_Rx* rx);
+
+
+/**
+ * Queues an event to be sent in the next frame. Sends the current frame
+ * first if it is full.
+ * @param tx - A pointer to the transmit queue
+ * @param event - The event byte
+ */
+void packet_queue (Packet_Tx* tx, uint8_t event);
+
+
+/**
+ * Sends the queued events as one frame. Does nothing if none are queued.
+ * @param tx - A pointer to the transmit queue
+ */
+void packet_flush (Packet_Tx* tx);
+
+
+/**
+ * Feeds a received byte to the receiver.
+ * @param rx - A pointer to the receiver
+ * @param byte - The received byte
+ * @return The number of events in rx->events when the byte completes a
+ * valid frame, 0 otherwise
+ */
+uint8_t packet_rx_byte (Packet_Rx* rx, uint8_t byte);
+
+
+#endif
@@ -0,0 +1,25 @@
+/** @file playfield.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 3 Nov 19
+ *  @brief A bitboard of the LED mat.
+ */
+
+
+#include "system.h"
+#include "tinygl.h"
+#include "playfield.h"
+
+
+/**
+ * Clears every point.
+ * @param field - A pointer to the playfield
+ */
+void playfield_clear (Playfield* field)
+{
+    uint8_t x;
+
+    for (x = 0; x < TINYGL_WIDTH; x++) {
+        field->cols[x] = 0;
+    }
+}
+
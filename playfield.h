@@ -0,0 +1,78 @@
+/** @file playfield.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 3 Nov 19
+ *  @brief A bitboard of the LED mat. Each column of the matrix is one
+ *  byte with bit y set when the pixel at row y is lit, so the whole 5x7
+ *  playfield fits in five bytes. Boards over 8 rows high use wider
+ *  columns.
+ */
+
+
+#ifndef PLAYFIELD_H
+#define PLAYFIELD_H
+
+
+#include "system.h"
+#include "tinygl.h"
+#include "geometry.h"
+
+
+#if TINYGL_HEIGHT <= 8
+typedef uint8_t playfield_col_t;
+#else
+typedef uint16_t playfield_col_t;
+#endif
+
+
+typedef struct playfield_s Playfield;
+
+
+struct playfield_s
+{
+    playfield_col_t cols[TINYGL_WIDTH];
+};
+
+
+/**
+ * Returns whether a point is on the LED mat.
+ * @param point - The point to check
+ * @return 1 if on the LED mat, 0 otherwise
+ */
+static inline uint8_t playfield_contains (tinygl_point_t point)
+{
+    return point.x >= 0 && point.x < TINYGL_WIDTH && point.y >= 0 && point.y < TINYGL_HEIGHT;
+}
+
+
+/**
+ * Returns the column mask for a single row.
+ * @param y - The row
+ * @return The mask with only bit y set
+ */
+static inline playfield_col_t playfield_row_mask (tinygl_coord_t y)
+{
+    return (playfield_col_t) 1 << y;
+}
+
+
+/**
+ * Lights a point. Points off the LED mat are ignored.
+ * @param field - A pointer to the playfield
+ * @param point - The point to light
+ */
+static inline void playfield_set (Playfield* field, tinygl_point_t point)
+{
+    if (playfield_contains (point)) {
+        field->cols[point.x] |= playfield_row_mask (point.y);
+    }
+}
+
+
+/**
+ * Clears every point.
+ * @param field - A pointer to the playfield
+ */
+void playfield_clear (Playfield* field);
+
+
+#endif
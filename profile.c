@@ -0,0 +1,148 @@
+/** @file profile.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 7 Nov 19
+ *  @brief Execution time counters for each step of a game tick.
+ */
+
+
+#include "system.h"
+#include "profile.h"
+
+#ifdef __AVR__
+#include "timer.h"
+#include "idle.h"
+#include "ir_uart.h"
+#include "dump.h"
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#endif
+
+
+static const char* const profile_names[PROFILE_NUM] = {"display", "signal", "input", "bullet", "cooldown", "message", "hits", "tick"};
+
+
+static Profile_Stat profile_stats[PROFILE_NUM];
+
+
+static profile_time_t profile_budget;
+
+
+/**
+ * Resets the counters. On a host the counters are also printed at exit.
+ * @param tick_rate - The game tick rate in Hz, which sets the overrun budget
+ */
+void profile_init (uint16_t tick_rate)
+{
+    uint8_t i;
+
+    for (i = 0; i < PROFILE_NUM; i++) {
+        profile_stats[i].count = 0;
+        profile_stats[i].total = 0;
+        profile_stats[i].min = UINT32_MAX;
+        profile_stats[i].max = 0;
+        profile_stats[i].overruns = 0;
+    }
+
+#ifdef __AVR__
+    profile_budget = IDLE_TIMER_RATE / tick_rate;
+#else
+    profile_budget = 1000000000UL / tick_rate;
+    atexit (profile_dump);
+#endif
+}
+
+
+/**
+ * Returns the current time.
+ * @return The time in profile units
+ */
+profile_time_t profile_now (void)
+{
+#ifdef __AVR__
+    return timer_get ();
+#else
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return (profile_time_t) (now.tv_sec * 1000000000ULL + now.tv_nsec);
+#endif
+}
+
+
+/**
+ * Records one run of a step.
+ * @param id - The step
+ * @param elapsed - How long it took in profile units
+ */
+void profile_record (profile_id_t id, profile_time_t elapsed)
+{
+    Profile_Stat* stat = &profile_stats[id];
+
+#ifdef __AVR__
+    elapsed = (timer_tick_t) elapsed; // the timer is only 16 bits wide
+#endif
+
+    stat->count++;
+    stat->total += elapsed;
+
+    if (elapsed < stat->min) {
+        stat->min = elapsed;
+    }
+
+    if (elapsed > stat->max) {
+        stat->max = elapsed;
+    }
+
+    if (elapsed > profile_budget) {
+        stat->overruns++;
+    }
+}
+
+
+/**
+ * Returns the counters for a step.
+ * @param id - The step
+ * @return A pointer to the counters
+ */
+const Profile_Stat* profile_stat (profile_id_t id)
+{
+    return &profile_stats[id];
+}
+
+
+/**
+ * Writes a line per step with its run count, min, max and mean time and
+ * overruns. Goes over the IR UART on the funkit and to stderr on a host.
+ */
+void profile_dump (void)
+{
+    uint8_t i;
+
+    for (i = 0; i < PROFILE_NUM; i++) {
+        const Profile_Stat* stat = &profile_stats[i];
+        profile_time_t min = stat->count ? stat->min : 0;
+        profile_time_t mean = stat->count ? stat->total / stat->count : 0;
+
+#ifdef __AVR__
+        ir_uart_puts (profile_names[i]);
+        ir_uart_putc (' ');
+        dump_u32 (stat->count);
+        ir_uart_putc (' ');
+        dump_u32 (min);
+        ir_uart_putc (' ');
+        dump_u32 (stat->max);
+        ir_uart_putc (' ');
+        dump_u32 (mean);
+        ir_uart_putc (' ');
+        dump_u32 (stat->overruns);
+        ir_uart_putc ('\n');
+#else
+        fprintf (stderr, "%-8s runs %10lu  min %8lu ns  max %8lu ns  mean %8lu ns  overruns %u\n",
+                 profile_names[i], (unsigned long) stat->count, (unsigned long) min,
+                 (unsigned long) stat->max, (unsigned long) mean, stat->overruns);
+#endif
+    }
+}
@@ -0,0 +1,99 @@
+/** @file profile.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 7 Nov 19
+ *  @brief Execution time counters for each step of a game tick. Built in
+ *  only when PROFILE is defined, otherwise the macros compile to nothing.
+ *  Times are CPU cycles on the funkit, where the profile build runs timer1
+ *  unprescaled (see idle.h), and nanoseconds on a host. A step longer than
+ *  the 16 bit timer's 8 ms wrap is misread on the funkit, but it has long
+ *  overrun its 2 ms tick by then.
+ */
+
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+
+#include "system.h"
+
+
+typedef enum profile_id {PROFILE_DISPLAY, PROFILE_SIGNAL, PROFILE_INPUT, PROFILE_BULLET,
+                         PROFILE_COOLDOWN, PROFILE_MESSAGE, PROFILE_HITS, PROFILE_TICK, PROFILE_NUM} profile_id_t;
+
+
+typedef uint32_t profile_time_t;
+
+
+typedef uint64_t profile_total_t;
+
+
+typedef struct profile_stat_s Profile_Stat;
+
+
+struct profile_stat_s
+{
+    uint32_t count;
+    profile_total_t total;
+    profile_time_t min;
+    profile_time_t max;
+    uint16_t overruns; // runs longer than a whole game tick
+};
+
+
+#ifdef PROFILE
+#define PROFILE_INIT(tick_rate) profile_init (tick_rate)
+#define PROFILE_START(id) profile_time_t profile_start_##id = profile_now ()
+#define PROFILE_STOP(id) profile_record (id, profile_now () - profile_start_##id)
+#else
+#define PROFILE_INIT(tick_rate)
+#define PROFILE_START(id)
+#define PROFILE_STOP(id)
+#endif
+
+
+/* Dumps on request on the funkit. A host dumps once at exit instead. */
+#if defined (PROFILE) && defined (__AVR__)
+#define PROFILE_DUMP() profile_dump ()
+#else
+#define PROFILE_DUMP()
+#endif
+
+
+/**
+ * Resets the counters. On a host the counters are also printed at exit.
+ * @param tick_rate - The game tick rate in Hz, which sets the overrun budget
+ */
+void profile_init (uint16_t tick_rate);
+
+
+/**
+ * Returns the current time.
+ * @return The time in profile units
+ */
+profile_time_t profile_now (void);
+
+
+/**
+ * Records one run of a step.
+ * @param id - The step
+ * @param elapsed - How long it took in profile units
+ */
+void profile_record (profile_id_t id, profile_time_t elapsed);
+
+
+/**
+ * Returns the counters for a step.
+ * @param id - The step
+ * @return A pointer to the counters
+ */
+const Profile_Stat* profile_stat (profile_id_t id);
+
+
+/**
+ * Writes a line per step with its run count, min, max and mean time and
+ * overruns. Goes over the IR UART on the funkit and to stderr on a host.
+ */
+void profile_dump (void);
+
+
+#endif
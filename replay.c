@@ -0,0 +1,303 @@
+/** @file replay.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 9 Nov 19
+ *  @brief A compact log of the inputs to the game, so a match can be
+ *  played back exactly.
+ */
+
+
+#include "system.h"
+#include "replay.h"
+
+#ifdef __AVR__
+#include "ir_uart.h"
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+#include <string.h>
+
+
+#define REPLAY_RECORD_MAX (5 + 1 + REPLAY_RX_MAX) // longest varint, tag and payload
+#define REPLAY_TRAILER_MAX (5 + 1 + 2 + 1 + 1) // a dropped record and the end record
+
+
+#ifndef __AVR__
+static FILE* replay_file;
+
+
+static Replay_Log* replay_file_log;
+
+
+/**
+ * Finishes the log file at exit.
+ */
+static void replay_exit (void)
+{
+    replay_dump (replay_file_log);
+    fclose (replay_file);
+}
+#endif
+
+
+/**
+ * Starts a log. On a host the log is only kept if FUNKIT_RECORD names a
+ * file to write it to, and the file is finished at exit.
+ * @param log - A pointer to the log
+ * @return 1 if the log is recording, 0 otherwise
+ */
+uint8_t replay_init (Replay_Log* log)
+{
+    log->len = 0;
+    log->tick = 0;
+    log->last_tick = 0;
+    log->dropped = 0;
+
+#ifndef __AVR__
+    const char* path = getenv ("FUNKIT_RECORD");
+
+    if (path == NULL || replay_file != NULL) {
+        return 0;
+    }
+
+    replay_file = fopen (path, "wb");
+    if (replay_file == NULL) {
+        perror (path);
+        return 0;
+    }
+
+    fwrite (REPLAY_MAGIC, 1, REPLAY_MAGIC_SIZE, replay_file);
+    replay_file_log = log;
+    atexit (replay_exit);
+#endif
+
+    return 1;
+}
+
+
+/**
+ * Makes room for a record. The funkit drops the record if the log is
+ * full, a host writes the log out to make room.
+ * @param log - A pointer to the log
+ * @return 1 if there is room, 0 if the record has to be dropped
+ */
+static uint8_t replay_reserve (Replay_Log* log)
+{
+    if (log->len + REPLAY_RECORD_MAX <= REPLAY_BUFFER_SIZE) {
+        return 1;
+    }
+
+#ifndef __AVR__
+    fwrite (log->buf, 1, log->len, replay_file);
+    log->len = 0;
+    return 1;
+#else
+    log->dropped++;
+    return 0;
+#endif
+}
+
+
+/**
+ * Encodes the start of a record: the ticks since the last record and the
+ * tag.
+ * @param out - Where to write the record, with room for REPLAY_RECORD_MAX bytes
+ * @param delta - The ticks since the last record
+ * @param tag - The tag byte
+ * @return The number of bytes written
+ */
+static uint8_t replay_encode_start (uint8_t* out, uint32_t delta, uint8_t tag)
+{
+    uint8_t len = 0;
+
+    while (delta >= 0x80) {
+        out[len++] = (delta & 0x7F) | 0x80;
+        delta >>= 7;
+    }
+    out[len++] = delta;
+    out[len++] = tag;
+
+    return len;
+}
+
+
+/**
+ * Starts a record in the log.
+ * @param log - A pointer to the log
+ * @param tag - The tag byte
+ */
+static void replay_start_record (Replay_Log* log, uint8_t tag)
+{
+    log->len += replay_encode_start (&log->buf[log->len], log->tick - log->last_tick, tag);
+    log->last_tick = log->tick;
+}
+
+
+/**
+ * Records navswitch events passed to an input step.
+ * @param log - A pointer to the log
+ * @param nav_events - The nav_event_t flags
+ */
+void replay_record_nav (Replay_Log* log, uint8_t nav_events)
+{
+    if (!replay_reserve (log)) {
+        return;
+    }
+
+    replay_start_record (log, REPLAY_TAG_NAV | (nav_events & REPLAY_NAV_MASK));
+}
+
+
+/**
+ * Records received IR bytes processed by a signal step.
+ * @param log - A pointer to the log
+ * @param bytes - The bytes
+ * @param count - The number of bytes, at most REPLAY_RX_MAX
+ */
+void replay_record_rx (Replay_Log* log, const uint8_t* bytes, uint8_t count)
+{
+    uint8_t i;
+
+    if (!replay_reserve (log)) {
+        return;
+    }
+
+    replay_start_record (log, REPLAY_TAG_RX | count);
+
+    for (i = 0; i < count; i++) {
+        log->buf[log->len++] = bytes[i];
+    }
+}
+
+
+/**
+ * Writes the log out with an end record: over the IR UART on the funkit,
+ * to the FUNKIT_RECORD file on a host. If records were dropped, a
+ * REPLAY_TAG_DROPPED record comes before the end, so a full log does not
+ * read as complete. These are not kept, so the funkit can carry on
+ * logging and dump again later.
+ * @param log - A pointer to the log
+ */
+void replay_dump (Replay_Log* log)
+{
+    uint8_t end[REPLAY_TRAILER_MAX];
+    uint8_t end_len = 0;
+
+    if (log->dropped != 0) {
+        end_len = replay_encode_start (end, log->tick - log->last_tick, REPLAY_TAG_DROPPED);
+        end[end_len++] = log->dropped & 0xFF;
+        end[end_len++] = log->dropped >> 8;
+        end_len += replay_encode_start (&end[end_len], 0, REPLAY_TAG_END);
+    } else {
+        end_len = replay_encode_start (end, log->tick - log->last_tick, REPLAY_TAG_END);
+    }
+
+#ifdef __AVR__
+    uint16_t i;
+
+    ir_uart_puts (REPLAY_MAGIC);
+
+    for (i = 0; i < log->len; i++) {
+        ir_uart_putc (log->buf[i]);
+    }
+
+    for (i = 0; i < end_len; i++) {
+        ir_uart_putc (end[i]);
+    }
+#else
+    fwrite (log->buf, 1, log->len, replay_file);
+    fwrite (end, 1, end_len, replay_file);
+    fflush (replay_file);
+    log->len = 0;
+#endif
+}
+
+
+/**
+ * Starts reading a log. The data may start with REPLAY_MAGIC.
+ * @param reader - A pointer to the reader
+ * @param data - The log
+ * @param len - The length of the log in bytes
+ */
+void replay_reader_init (Replay_Reader* reader, const uint8_t* data, uint32_t len)
+{
+    reader->data = data;
+    reader->len = len;
+    reader->pos = 0;
+    reader->tick = 0;
+
+    if (len >= REPLAY_MAGIC_SIZE && memcmp (data, REPLAY_MAGIC, REPLAY_MAGIC_SIZE) == 0) {
+        reader->pos = REPLAY_MAGIC_SIZE;
+    }
+}
+
+
+/**
+ * Reads the next record.
+ * @param reader - A pointer to the reader
+ * @param record - Set to the record. Its rx_bytes point into the log.
+ * @return 1 if a record was read, 0 at the end of the log or if the rest
+ * of the log is cut short
+ */
+uint8_t replay_next (Replay_Reader* reader, Replay_Record* record)
+{
+    uint32_t pos = reader->pos;
+    uint32_t delta = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+
+    do {
+        if (pos == reader->len || shift > 28) {
+            return 0;
+        }
+        byte = reader->data[pos++];
+        delta |= (uint32_t) (byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    if (pos == reader->len) {
+        return 0;
+    }
+    byte = reader->data[pos++];
+
+    record->tick = reader->tick + delta;
+    record->nav_events = 0;
+    record->rx_count = 0;
+    record->rx_bytes = NULL;
+    record->dropped = 0;
+
+    if (byte & REPLAY_TAG_RX) {
+        record->tag = REPLAY_TAG_RX;
+        record->rx_count = byte & ~REPLAY_TAG_RX;
+        record->rx_bytes = &reader->data[pos];
+
+        if (record->rx_count > REPLAY_RX_MAX || reader->len - pos < record->rx_count) {
+            return 0;
+        }
+        pos += record->rx_count;
+
+    } else if (byte == REPLAY_TAG_END) {
+        record->tag = REPLAY_TAG_END;
+
+    } else if (byte == REPLAY_TAG_DROPPED) {
+        record->tag = REPLAY_TAG_DROPPED;
+
+        if (reader->len - pos < 2) {
+            return 0;
+        }
+        record->dropped = reader->data[pos] | reader->data[pos + 1] << 8;
+        pos += 2;
+
+    } else if ((byte & ~REPLAY_NAV_MASK) == REPLAY_TAG_NAV) {
+        record->tag = REPLAY_TAG_NAV;
+        record->nav_events = byte;
+
+    } else {
+        return 0;
+    }
+
+    reader->pos = pos;
+    reader->tick = record->tick;
+
+    return 1;
+}
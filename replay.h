@@ -0,0 +1,158 @@
+/** @file replay.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 9 Nov 19
+ *  @brief A compact log of the inputs to the game, so a match can be
+ *  played back exactly. Each record is a varint count of ticks since the
+ *  last record, a tag byte and the tag's payload:
+ *
+ *      000nnnnn            navswitch events n (nav_event_t flags)
+ *      1000cccc + c bytes  c received IR bytes, in the order processed
+ *      01000000            end of the log
+ *      01000001 + 2 bytes  the log filled up and this many records after
+ *                          it did not fit, low byte first
+ *
+ *  Ticks are counted by the log itself, not read from game_data->tick,
+ *  since a clock sync can move the game clock.
+ */
+
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+
+#include "system.h"
+
+
+#ifndef REPLAY_BUFFER_SIZE
+#define REPLAY_BUFFER_SIZE 128
+#endif
+
+
+#define REPLAY_MAGIC "FKR1" // starts a log written to a file or dumped
+#define REPLAY_MAGIC_SIZE 4
+
+
+#define REPLAY_TAG_NAV 0x00
+#define REPLAY_TAG_RX 0x80
+#define REPLAY_TAG_END 0x40
+#define REPLAY_TAG_DROPPED 0x41
+#define REPLAY_NAV_MASK 0x1F
+#define REPLAY_RX_MAX 15
+
+
+typedef struct replay_log_s Replay_Log;
+
+
+typedef struct replay_reader_s Replay_Reader;
+
+
+typedef struct replay_record_s Replay_Record;
+
+
+/* The funkit keeps the log in RAM and counts the records that did not
+ * fit, and a dump of a full log says how many were lost. A host writes
+ * the buffer out to a file each time it fills. */
+struct replay_log_s
+{
+    uint8_t buf[REPLAY_BUFFER_SIZE];
+    uint16_t len;
+    uint32_t tick; // ticks since the log was started
+    uint32_t last_tick; // tick of the last record
+    uint16_t dropped; // records that did not fit
+};
+
+
+struct replay_reader_s
+{
+    const uint8_t* data;
+    uint32_t len;
+    uint32_t pos;
+    uint32_t tick;
+};
+
+
+struct replay_record_s
+{
+    uint32_t tick;
+    uint8_t tag; // REPLAY_TAG_NAV, REPLAY_TAG_RX, REPLAY_TAG_END or REPLAY_TAG_DROPPED
+    uint8_t nav_events;
+    uint16_t dropped; // records lost, for REPLAY_TAG_DROPPED
+    uint8_t rx_count;
+    const uint8_t* rx_bytes;
+};
+
+
+/* The log is only dumped on request on the funkit. A host writes it out
+ * as it goes. */
+#if defined (REPLAY) && defined (__AVR__)
+#define REPLAY_DUMP(log) replay_dump (log)
+#else
+#define REPLAY_DUMP(log)
+#endif
+
+
+/**
+ * Starts a log. On a host the log is only kept if FUNKIT_RECORD names a
+ * file to write it to, and the file is finished at exit.
+ * @param log - A pointer to the log
+ * @return 1 if the log is recording, 0 otherwise
+ */
+uint8_t replay_init (Replay_Log* log);
+
+
+/**
+ * Records navswitch events passed to an input step.
+ * @param log - A pointer to the log
+ * @param nav_events - The nav_event_t flags
+ */
+void replay_record_nav (Replay_Log* log, uint8_t nav_events);
+
+
+/**
+ * Records received IR bytes processed by a signal step.
+ * @param log - A pointer to the log
+ * @param bytes - The bytes
+ * @param count - The number of bytes, at most REPLAY_RX_MAX
+ */
+void replay_record_rx (Replay_Log* log, const uint8_t* bytes, uint8_t count);
+
+
+/**
+ * Moves the log on to the next tick.
+ * @param log - A pointer to the log
+ */
+static inline void replay_tick (Replay_Log* log)
+{
+    log->tick++;
+}
+
+
+/**
+ * Writes the log out with an end record: over the IR UART on the funkit,
+ * to the FUNKIT_RECORD file on a host. If records were dropped, a
+ * REPLAY_TAG_DROPPED record comes before the end.
+ * @param log - A pointer to the log
+ */
+void replay_dump (Replay_Log* log);
+
+
+/**
+ * Starts reading a log. The data may start with REPLAY_MAGIC.
+ * @param reader - A pointer to the reader
+ * @param data - The log
+ * @param len - The length of the log in bytes
+ */
+void replay_reader_init (Replay_Reader* reader, const uint8_t* data, uint32_t len);
+
+
+/**
+ * Reads the next record.
+ * @param reader - A pointer to the reader
+ * @param record - Set to the record. Its rx_bytes point into the log.
+ * @return 1 if a record was read, 0 at the end of the log or if the rest
+ * of the log is cut short
+ */
+uint8_t replay_next (Replay_Reader* reader, Replay_Record* record);
+
+
+#endif
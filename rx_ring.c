@@ -0,0 +1,114 @@
+/** @file rx_ring.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 5 Nov 19
+ *  @brief A ring buffer of received IR bytes.
+ */
+
+
+#include "system.h"
+#include "ir_uart.h"
+#include "rx_ring.h"
+
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#endif
+
+
+#define RX_RING_MASK (RX_RING_SIZE - 1)
+
+
+#ifdef __AVR__
+static Rx_Ring* rx_isr_ring;
+
+
+/**
+ * Receive interrupt. Moves the byte from the USART straight into the ring.
+ */
+ISR (USART1_RX_vect)
+{
+    uint8_t byte = UDR1;
+
+    if (rx_isr_ring) {
+        rx_ring_push (rx_isr_ring, byte);
+    }
+}
+#endif
+
+
+/**
+ * Empties the ring.
+ * @param ring - A pointer to the ring
+ */
+void rx_ring_init (Rx_Ring* ring)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overflow_count = 0;
+}
+
+
+/**
+ * Adds a received byte. The byte is dropped if the ring is full.
+ * @param ring - A pointer to the ring
+ * @param byte - The received byte
+ */
+void rx_ring_push (Rx_Ring* ring, uint8_t byte)
+{
+    uint8_t head = ring->head;
+
+    if (rx_ring_full (ring)) {
+        ring->overflow_count++;
+        return;
+    }
+
+    ring->buf[head] = byte;
+    ring->head = (head + 1) & RX_RING_MASK;
+}
+
+
+/**
+ * Takes the oldest byte. The ring must not be empty.
+ * @param ring - A pointer to the ring
+ * @return The byte
+ */
+uint8_t rx_ring_pop (Rx_Ring* ring)
+{
+    uint8_t tail = ring->tail;
+    uint8_t byte = ring->buf[tail];
+
+    ring->tail = (tail + 1) & RX_RING_MASK;
+
+    return byte;
+}
+
+
+/**
+ * Routes the IR receive interrupt into a ring. Call after ir_uart_init.
+ * @param ring - A pointer to the ring
+ */
+void rx_ring_attach (__unused__ Rx_Ring* ring)
+{
+#ifdef __AVR__
+    cli ();
+    rx_isr_ring = ring;
+    UCSR1B |= BIT (RXCIE1);
+    sei ();
+#endif
+}
+
+
+/**
+ * Moves bytes waiting in the IR UART into the ring until it is full, the
+ * rest wait in the UART for the next tick. Does nothing on the funkit,
+ * where the receive interrupt fills the ring.
+ * @param ring - A pointer to the ring
+ */
+void rx_ring_fill (__unused__ Rx_Ring* ring)
+{
+#ifndef __AVR__
+    while (!rx_ring_full (ring) && ir_uart_read_ready_p ()) {
+        rx_ring_push (ring, ir_uart_getc ());
+    }
+#endif
+}
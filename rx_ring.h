@@ -0,0 +1,96 @@
+/** @file rx_ring.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 5 Nov 19
+ *  @brief A ring buffer of received IR bytes. On the funkit it is filled
+ *  by the USART1 receive interrupt and emptied by the game, so no byte
+ *  waits for a polling task to come round.
+ */
+
+
+#ifndef RX_RING_H
+#define RX_RING_H
+
+
+#include "system.h"
+
+
+#define RX_RING_SIZE 16 // must be a power of two
+
+
+typedef struct rx_ring_s Rx_Ring;
+
+
+/* Single producer (the receive interrupt), single consumer (the game).
+ * The producer only writes head and the consumer only writes tail. */
+struct rx_ring_s
+{
+    uint8_t buf[RX_RING_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    uint8_t overflow_count; // bytes dropped because the ring was full
+};
+
+
+/**
+ * Empties the ring.
+ * @param ring - A pointer to the ring
+ */
+void rx_ring_init (Rx_Ring* ring);
+
+
+/**
+ * Returns whether the ring is empty.
+ * @param ring - A pointer to the ring
+ * @return 1 if there is nothing to read, 0 otherwise
+ */
+static inline uint8_t rx_ring_empty (const Rx_Ring* ring)
+{
+    return ring->head == ring->tail;
+}
+
+
+/**
+ * Returns whether the ring is full. One slot is always left free.
+ * @param ring - A pointer to the ring
+ * @return 1 if a push would be dropped, 0 otherwise
+ */
+static inline uint8_t rx_ring_full (const Rx_Ring* ring)
+{
+    return ((ring->head + 1) & (RX_RING_SIZE - 1)) == ring->tail;
+}
+
+
+/**
+ * Adds a received byte. The byte is dropped if the ring is full.
+ * @param ring - A pointer to the ring
+ * @param byte - The received byte
+ */
+void rx_ring_push (Rx_Ring* ring, uint8_t byte);
+
+
+/**
+ * Takes the oldest byte. The ring must not be empty.
+ * @param ring - A pointer to the ring
+ * @return The byte
+ */
+uint8_t rx_ring_pop (Rx_Ring* ring);
+
+
+/**
+ * Routes the IR receive interrupt into a ring. Call after ir_uart_init.
+ * @param ring - A pointer to the ring
+ */
+void rx_ring_attach (Rx_Ring* ring);
+
+
+/**
+ * Moves bytes waiting in the IR UART into the ring until it is full, the
+ * rest wait in the UART for the next tick. Does nothing on the funkit,
+ * where the receive interrupt fills the ring; the host build calls it
+ * once per tick in place of the interrupt.
+ * @param ring - A pointer to the ring
+ */
+void rx_ring_fill (Rx_Ring* ring);
+
+
+#endif
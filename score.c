@@ -0,0 +1,173 @@
+/** @file score.c
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 11 Nov 19
+ *  @brief The "Score own|enemy" banner shown between rounds.
+ */
+
+
+#include "system.h"
+#include "font.h"
+#include "score.h"
+#include "../fonts/font5x5_1.h"
+
+
+#define SCORE_PREFIX "Score "
+#define SCORE_PREFIX_LEN 6
+
+
+/**
+ * Writes a number in decimal without leading zeros.
+ * @param out - Where to write the digits, at least 3 chars
+ * @param value - The number
+ * @return The number of digits written
+ */
+static uint8_t format_u8 (char* out, uint8_t value)
+{
+    uint8_t len = 0;
+
+    if (value >= 100) {
+        out[len++] = '0' + value / 100;
+        value %= 100;
+        out[len++] = '0' + value / 10;
+
+    } else if (value >= 10) {
+        out[len++] = '0' + value / 10;
+    }
+
+    out[len++] = '0' + value % 10;
+
+    return len;
+}
+
+
+/**
+ * Empties the score banner, so the next score_banner_show builds it.
+ * @param banner - A pointer to the score banner
+ */
+void score_banner_init (Score_Banner* banner)
+{
+    banner->len = 0;
+    banner->offset = 0;
+    banner->own = 0;
+    banner->enemy = 0;
+}
+
+
+/**
+ * Writes "Score own|enemy".
+ * @param out - Where to write the text, at least SCORE_TEXT_SIZE chars
+ * @param own - Our score
+ * @param enemy - The enemy's score
+ * @return The length of the text, not counting the terminating nul
+ */
+uint8_t score_format (char* out, uint8_t own, uint8_t enemy)
+{
+    uint8_t len;
+
+    for (len = 0; len < SCORE_PREFIX_LEN; len++) {
+        out[len] = SCORE_PREFIX[len];
+    }
+
+    len += format_u8 (&out[len], own);
+    out[len++] = '|';
+    len += format_u8 (&out[len], enemy);
+    out[len] = '\0';
+
+    return len;
+}
+
+
+/**
+ * Rasterises the text for a pair of scores into the banner's columns.
+ * @param banner - A pointer to the score banner
+ * @param own - Our score
+ * @param enemy - The enemy's score
+ */
+static void score_banner_build (Score_Banner* banner, uint8_t own, uint8_t enemy)
+{
+    char text[SCORE_TEXT_SIZE];
+    uint8_t len = score_format (text, own, enemy);
+    uint8_t i;
+    uint8_t col;
+    uint8_t row;
+
+    banner->len = 0;
+
+    for (i = 0; i < len; i++) {
+        for (col = 0; col < SCORE_FONT_WIDTH; col++) {
+            uint8_t bits = 0;
+
+            for (row = 0; row < SCORE_FONT_HEIGHT && row < TINYGL_HEIGHT; row++) {
+                if (font_pixel_get (&font5x5_1, text[i], col, row)) {
+                    bits |= 1 << row;
+                }
+            }
+
+            banner->cols[banner->len++] = bits;
+        }
+
+        banner->cols[banner->len++] = 0;
+    }
+
+    banner->own = own;
+    banner->enemy = enemy;
+}
+
+
+/**
+ * Draws the display's worth of the banner from its current offset. Columns
+ * past the end of the text are blank.
+ * @param banner - A pointer to the score banner
+ * @param fb - A pointer to the framebuffer to draw into
+ */
+static void score_banner_draw (const Score_Banner* banner, Framebuffer* fb)
+{
+    uint8_t x;
+
+    for (x = 0; x < TINYGL_WIDTH; x++) {
+        uint16_t col = banner->offset + x;
+
+        if (col >= banner->len + TINYGL_WIDTH) {
+            col -= banner->len + TINYGL_WIDTH;
+        }
+
+        framebuffer_draw_column (fb, x, col < banner->len ? banner->cols[col] : 0);
+    }
+}
+
+
+/**
+ * Draws the start of the banner for a pair of scores, rebuilding it only
+ * if the scores have changed since it was last built.
+ * @param banner - A pointer to the score banner
+ * @param own - Our score
+ * @param enemy - The enemy's score
+ * @param fb - A pointer to the framebuffer to draw into
+ */
+void score_banner_show (Score_Banner* banner, uint8_t own, uint8_t enemy, Framebuffer* fb)
+{
+    if (banner->len == 0 || banner->own != own || banner->enemy != enemy) {
+        score_banner_build (banner, own, enemy);
+    }
+
+    banner->offset = 0;
+    score_banner_draw (banner, fb);
+}
+
+
+/**
+ * Scrolls the banner left by one column. Blank columns follow the text so
+ * it scrolls fully off the display before it repeats.
+ * @param banner - A pointer to the score banner
+ * @param fb - A pointer to the framebuffer to draw into
+ */
+void score_banner_scroll (Score_Banner* banner, Framebuffer* fb)
+{
+    banner->offset++;
+
+    if (banner->offset >= banner->len + TINYGL_WIDTH) {
+        banner->offset = 0;
+    }
+
+    score_banner_draw (banner, fb);
+}
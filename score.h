@@ -0,0 +1,78 @@
+/** @file score.h
+ *  @authors Lewis Thorp, Lydia Looi
+ *  @date 11 Nov 19
+ *  @brief The "Score own|enemy" banner shown between rounds. The text is
+ *  built without pulling in sprintf and rasterised once into a column
+ *  bitmap, which is only rebuilt when a score changes. Scrolling the
+ *  banner is then a copy of TINYGL_WIDTH columns into the framebuffer.
+ */
+
+
+#ifndef SCORE_H
+#define SCORE_H
+
+
+#include "system.h"
+#include "framebuffer.h"
+
+
+#define SCORE_TEXT_SIZE 14 // "Score 255|255" and the terminating nul
+#define SCORE_FONT_WIDTH 5 // columns of a font5x5_1 glyph
+#define SCORE_FONT_HEIGHT 5
+#define SCORE_BANNER_COLS ((SCORE_TEXT_SIZE - 1) * (SCORE_FONT_WIDTH + 1)) // a glyph and a blank column per char
+
+
+_Static_assert (SCORE_FONT_HEIGHT <= 8, "banner columns must fit in a byte");
+
+
+typedef struct score_banner_s Score_Banner;
+
+
+struct score_banner_s
+{
+    uint8_t cols[SCORE_BANNER_COLS]; // bit y set when row y of the column is lit
+    uint8_t len; // columns in use, 0 until the banner is built
+    uint8_t offset; // banner column at the left of the display
+    uint8_t own; // scores the banner was built for
+    uint8_t enemy;
+};
+
+
+/**
+ * Empties the score banner, so the next score_banner_show builds it.
+ * @param banner - A pointer to the score banner
+ */
+void score_banner_init (Score_Banner* banner);
+
+
+/**
+ * Writes "Score own|enemy".
+ * @param out - Where to write the text, at least SCORE_TEXT_SIZE chars
+ * @param own - Our score
+ * @param enemy - The enemy's score
+ * @return The length of the text, not counting the terminating nul
+ */
+uint8_t score_format (char* out, uint8_t own, uint8_t enemy);
+
+
+/**
+ * Draws the start of the banner for a pair of scores, rebuilding it only
+ * if the scores have changed since it was last built.
+ * @param banner - A pointer to the score banner
+ * @param own - Our score
+ * @param enemy - The enemy's score
+ * @param fb - A pointer to the framebuffer to draw into
+ */
+void score_banner_show (Score_Banner* banner, uint8_t own, uint8_t enemy, Framebuffer* fb);
+
+
+/**
+ * Scrolls the banner left by one column. Blank columns follow the text so
+ * it scrolls fully off the display before it repeats.
+ * @param banner - A pointer to the score banner
+ * @param fb - A pointer to the framebuffer to draw into
+ */
+void score_banner_scroll (Score_Banner* banner, Framebuffer* fb);
+
+
+#endif
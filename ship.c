@@ -7,129 +7,155 @@
 
 #include "system.h"
 #include "tinygl.h"
+#include "framebuffer.h"
 #include "ship.h"
+#include "geometry.h"
+#include "latency.h"
 
 
-#define MIN_Y 0
-#define MAX_Y 6
+#ifdef __AVR__
+#define SHIP_TABLE const __flash // read straight from flash to save 256 bytes of SRAM
+#else
+#define SHIP_TABLE const
+#endif
+
+
+#define SHIP_STATE(y, aim) (((y) << SHIP_AIM_BITS) | (aim))
+
+
+/* Whether the loaded bullet of a ship on row y with an aim is on the mat. */
+#define SHIP_AIM_FITS(y, aim) (((aim) != LEFT || (y) > MIN_Y) && ((aim) != RIGHT || (y) < MAX_Y))
+
+
+/* A move keeps the aim unless that would put the loaded bullet off the
+ * mat, then the ship aims straight. An aim that would is not taken. */
+#define SHIP_MOVED(y, aim, to_y) SHIP_STATE (to_y, SHIP_AIM_FITS (to_y, aim) ? (aim) : DIRECT)
+#define SHIP_AIMED(y, aim, to_aim) SHIP_STATE (y, SHIP_AIM_FITS (y, to_aim) ? (to_aim) : (aim))
+
+
+#define SHIP_ENTRY(y, aim) { \
+    [SHIP_MOVE_LEFT] = SHIP_MOVED (y, aim, (y) < MAX_Y ? (y) + 1 : (y)), \
+    [SHIP_MOVE_RIGHT] = SHIP_MOVED (y, aim, (y) > MIN_Y ? (y) - 1 : (y)), \
+    [SHIP_AIM_LEFT] = SHIP_AIMED (y, aim, (aim) > LEFT ? (aim) - 1 : (aim)), \
+    [SHIP_AIM_RIGHT] = SHIP_AIMED (y, aim, (aim) < RIGHT ? (aim) + 1 : (aim))}
+
+
+/* The unused fourth aim of each row is left as zeros. */
+#define SHIP_ROW(y) SHIP_ENTRY (y, LEFT), SHIP_ENTRY (y, DIRECT), SHIP_ENTRY (y, RIGHT), {0}
+
+
+/* The state each navswitch event takes the ship to from each state,
+ * worked out by the compiler. Every row a board can have is listed,
+ * rows past MAX_Y are never reached. */
+static SHIP_TABLE uint8_t ship_next[16 << SHIP_AIM_BITS][SHIP_NUM_EVENTS] = {
+    SHIP_ROW (0), SHIP_ROW (1), SHIP_ROW (2), SHIP_ROW (3),
+    SHIP_ROW (4), SHIP_ROW (5), SHIP_ROW (6), SHIP_ROW (7),
+    SHIP_ROW (8), SHIP_ROW (9), SHIP_ROW (10), SHIP_ROW (11),
+    SHIP_ROW (12), SHIP_ROW (13), SHIP_ROW (14), SHIP_ROW (15),
+};
+
+
+_Static_assert (TINYGL_HEIGHT <= 16, "ship_next only has 16 rows");
 
 
 /**
- * Sets the postion of loaded bullet.
+ * Puts the ship on a row, aimed straight ahead.
  * @param ship - A pointer to the ship
+ * @param y - The row
  */
-void set_loaded_pos (Ship* ship)
+void ship_init (Ship* ship, tinygl_coord_t y)
 {
-    tinygl_draw_point (ship->loaded_bullet_pos, 0);
-    tinygl_point_t loaded_bullet_pos = {ship->ship_pos.x-1, ship->ship_pos.y};
-
-    switch (ship->aim) {
-        case LEFT:
-            loaded_bullet_pos.y = loaded_bullet_pos.y - 1;
-            ship->loaded_bullet_pos = loaded_bullet_pos;
-            break;
-
-        case RIGHT:
-            loaded_bullet_pos.y = loaded_bullet_pos.y + 1;
-            ship->loaded_bullet_pos = loaded_bullet_pos;
-            break;
-
-        case DIRECT:
-            ship->loaded_bullet_pos = loaded_bullet_pos;
-            break;
-    }
+    ship->state = SHIP_STATE (y, DIRECT);
 }
 
 
 /**
  * Draws ship on LED mat.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void show_ship (Ship* ship, uint8_t ready)
+void show_ship (Framebuffer* fb, Ship* ship, uint8_t ready)
 {
-    tinygl_draw_point (ship->ship_pos, 1);
-    tinygl_draw_point (ship->loaded_bullet_pos, ready);
+    framebuffer_draw_point (fb, ship_pos (ship), 1);
+    framebuffer_draw_point (fb, ship_loaded_pos (ship), ready);
 }
 
 
 /**
  * Hides the ship
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  */
-void hide_ship(Ship* ship)
+void hide_ship(Framebuffer* fb, Ship* ship)
 {
-    tinygl_draw_point (ship->ship_pos, 0);
-    tinygl_draw_point (ship->loaded_bullet_pos, 0);
+    framebuffer_draw_point (fb, ship_pos (ship), 0);
+    framebuffer_draw_point (fb, ship_loaded_pos (ship), 0);
 }
 
 
 /**
- * Moves ship one position to the right.
+ * Moves the ship to the state a navswitch event leads to and redraws it.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
+ * @param event - The navswitch event
  */
-void ship_move_right (Ship* ship, uint8_t ready)
+static void ship_apply (Framebuffer* fb, Ship* ship, uint8_t ready, ship_event_t event)
 {
-    if (ship->ship_pos.y > MIN_Y) {
+    hide_ship (fb, ship);
+    ship->state = ship_next[ship->state][event];
+    show_ship (fb, ship, ready);
+}
 
-        tinygl_draw_point (ship->ship_pos, 0);
-        tinygl_draw_point (ship->loaded_bullet_pos, 0);
-        ship->ship_pos.y--;
-        set_loaded_pos(ship);
-    }
 
-    show_ship (ship, ready);
+/**
+ * Moves ship one position to the right.
+ * @param fb - A pointer to the framebuffer
+ * @param ship - A pointer to the ship
+ * @param ready - Whether or not the ship can fire or not
+ */
+void ship_move_right (Framebuffer* fb, Ship* ship, uint8_t ready)
+{
+    LATENCY_MOVE_START(ship_y (ship));
+    ship_apply (fb, ship, ready, SHIP_MOVE_RIGHT);
+    LATENCY_MOVE_STOP(ship_y (ship));
 }
 
 
 /**
  * Moves ship one position to the left.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void ship_move_left (Ship* ship, uint8_t ready)
+void ship_move_left (Framebuffer* fb, Ship* ship, uint8_t ready)
 {
-    if (ship->ship_pos.y < MAX_Y) {
-
-        tinygl_draw_point (ship->ship_pos, 0);
-        tinygl_draw_point (ship->loaded_bullet_pos, 0);
-
-        ship->ship_pos.y++;
-        set_loaded_pos(ship);
-    }
-
-    show_ship (ship, ready);
+    LATENCY_MOVE_START(ship_y (ship));
+    ship_apply (fb, ship, ready, SHIP_MOVE_LEFT);
+    LATENCY_MOVE_STOP(ship_y (ship));
 }
 
 
 /**
  * Moves loaded bullet one position to the left.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void ship_aim_left(Ship* ship, uint8_t ready)
+void ship_aim_left(Framebuffer* fb, Ship* ship, uint8_t ready)
 {
-    if (ship->ship_pos.y < MAX_Y && ship->aim != LEFT) {
-        ship->aim--;
-    }
-
-    set_loaded_pos(ship);
-    show_ship (ship, ready);
+    ship_apply (fb, ship, ready, SHIP_AIM_LEFT);
 }
 
 
 /**
  * Moves loaded bullet one position to the right.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void ship_aim_right(Ship* ship, uint8_t ready)
+void ship_aim_right(Framebuffer* fb, Ship* ship, uint8_t ready)
 {
-    if (ship->ship_pos.y > MIN_Y && ship->aim != RIGHT) {
-        ship->aim++;
-    }
-
-    set_loaded_pos(ship);
-    show_ship (ship, ready);
+    ship_apply (fb, ship, ready, SHIP_AIM_RIGHT);
 }
@@ -10,6 +10,12 @@
 
 
 #include "system.h"
+#include "tinygl.h"
+#include "framebuffer.h"
+#include "geometry.h"
+
+
+#define SHIP_AIM_BITS 2 // the low bits of a ship state hold its aim
 
 
 typedef struct ship_data Ship;
@@ -18,65 +24,122 @@ typedef struct ship_data Ship;
 enum aim_dir {LEFT, DIRECT, RIGHT};
 
 
+typedef enum ship_event {SHIP_MOVE_LEFT, SHIP_MOVE_RIGHT, SHIP_AIM_LEFT, SHIP_AIM_RIGHT, SHIP_NUM_EVENTS} ship_event_t;
+
+
+/* The ship is always on the bottom row, so its row y and aim are all
+ * there is to it. They are kept together as one state, y << SHIP_AIM_BITS
+ * | aim, which indexes the table of moves in ship.c. */
 struct ship_data {
-    tinygl_point_t ship_pos;
-    tinygl_point_t loaded_bullet_pos;
-    uint8_t aim;
+    uint8_t state;
 };
 
 
 /**
- * Sets the postion of loaded bullet.
+ * Returns the row of the ship.
+ * @param ship - A pointer to the ship
+ * @return The y position of the ship
+ */
+static inline tinygl_coord_t ship_y (const Ship* ship)
+{
+    return ship->state >> SHIP_AIM_BITS;
+}
+
+
+/**
+ * Returns the aim of the ship.
+ * @param ship - A pointer to the ship
+ * @return LEFT, DIRECT or RIGHT
+ */
+static inline uint8_t ship_aim (const Ship* ship)
+{
+    return ship->state & ((1 << SHIP_AIM_BITS) - 1);
+}
+
+
+/**
+ * Returns the position of the ship.
+ * @param ship - A pointer to the ship
+ * @return The position of the ship
+ */
+static inline tinygl_point_t ship_pos (const Ship* ship)
+{
+    return tinygl_point (BOT_OF_MATRIX, ship_y (ship));
+}
+
+
+/**
+ * Returns the position of the loaded bullet, just in front of the ship
+ * and one row to the side it is aimed at. The ship's moves keep it on
+ * the LED mat.
+ * @param ship - A pointer to the ship
+ * @return The position of the loaded bullet
+ */
+static inline tinygl_point_t ship_loaded_pos (const Ship* ship)
+{
+    return tinygl_point (BOT_OF_MATRIX - 1, ship_y (ship) + ship_aim (ship) - DIRECT);
+}
+
+
+/**
+ * Puts the ship on a row, aimed straight ahead.
  * @param ship - A pointer to the ship
+ * @param y - The row
  */
-void set_loaded_pos (Ship* ship);
+void ship_init (Ship* ship, tinygl_coord_t y);
 
 
 /**
  * Draws ship on LED mat.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void show_ship(Ship* ship, uint8_t ready);
+void show_ship(Framebuffer* fb, Ship* ship, uint8_t ready);
 
 
 /**
  * Hides the ship
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  */
-void hide_ship(Ship* ship);
+void hide_ship(Framebuffer* fb, Ship* ship);
 
 
 /**
  * Moves ship one position to the right.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void ship_move_right(Ship* ship, uint8_t ready);
+void ship_move_right(Framebuffer* fb, Ship* ship, uint8_t ready);
 
 
 /**
  * Moves ship one position to the left.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void ship_move_left(Ship* ship, uint8_t ready);
+void ship_move_left(Framebuffer* fb, Ship* ship, uint8_t ready);
 
 
 /**
  * Moves loaded bullet one position to the left.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void ship_aim_left(Ship* ship, uint8_t ready);
+void ship_aim_left(Framebuffer* fb, Ship* ship, uint8_t ready);
 
 
 /**
  * Moves loaded bullet one position to the right.
+ * @param fb - A pointer to the framebuffer
  * @param ship - A pointer to the ship
  * @param ready - Whether or not the ship can fire or not
  */
-void ship_aim_right(Ship* ship, uint8_t ready);
+void ship_aim_right(Framebuffer* fb, Ship* ship, uint8_t ready);
 
 
 #endif
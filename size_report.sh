@@ -0,0 +1,192 @@
+#!/bin/sh
+# File:   size_report.sh
+# Author: Lewis Thorp, Lydia Looi
+# Date:   12 Nov 19
+# Descr:  Prints the flash and SRAM used by each object file and its
+#         symbols, and checks the modules against a baseline.
+#
+# Usage:  size_report.sh SIZE NM BASELINE THRESHOLD FILE...
+#
+# Sizes are counted by section.  Code and __flash data (.text, .progmem)
+# take only flash, initialised data and plain const data (.data, .rodata)
+# take flash and are copied into SRAM at start up, and .bss and .noinit
+# take only SRAM.  Each module is compared against its line in BASELINE,
+# and the script fails if a module or the total of all the .o files grew
+# by more than THRESHOLD bytes of flash or SRAM, or if there is no
+# BASELINE.  With UPDATE=1 the BASELINE is rewritten from this build
+# instead.
+#
+# Objects built with -flto (RELEASE=1) hold only compiler IR, so their
+# sizes say nothing about the final image.  Then only the linked image and
+# its symbols are reported, and the image is compared against the image
+# line of the BASELINE, which comes from a normal build.
+
+SIZE=$1
+NM=$2
+BASELINE=$3
+THRESHOLD=$4
+shift 4
+
+REPORT=$(mktemp)
+trap 'rm -f "$REPORT"' EXIT
+
+# Where a section lives: flash, flash+sram, sram, or nothing for debug
+# and other sections that are not loaded.
+SECTION_AWK='
+    function where(section) {
+        if (section ~ /^\.(text|progmem|init|fini|vectors|trampolines|ctors|dtors|jumptables|lowtext)/) {
+            return "flash"
+        }
+        if (section ~ /^\.(data|rodata)/) {
+            return "flash+sram"
+        }
+        if (section ~ /^\.(bss|noinit)/) {
+            return "sram"
+        }
+        return ""
+    }
+'
+
+LTO=0
+for file in "$@"; do
+    case $file in
+        *.o) ;;
+        *) continue ;;
+    esac
+
+    if $SIZE -A "$file" | awk '$1 ~ /^\.gnu\.lto_/ {lto = 1} END {exit !lto}'; then
+        LTO=1
+    fi
+done
+
+if [ "$LTO" = 1 ]; then
+    if [ "$UPDATE" = 1 ]; then
+        echo "The objects hold LTO IR, not code.  Run make clean and build without RELEASE=1 to write $BASELINE." >&2
+        exit 1
+    fi
+
+    echo "The objects hold LTO IR, only the linked image is sized."
+    echo
+
+    for file in "$@"; do
+        shift
+        case $file in
+            *.o) ;;
+            *) set -- "$@" "$file" ;;
+        esac
+    done
+fi
+
+# One line per file: name flash sram.
+for file in "$@"; do
+    $SIZE -A "$file" | awk -v name="$(basename "$file")" "$SECTION_AWK"'
+        NF >= 2 && $2 ~ /^[0-9]+$/ {
+            w = where($1)
+            if (w == "flash") {
+                flash += $2
+            } else if (w == "flash+sram") {
+                flash += $2; sram += $2
+            } else if (w == "sram") {
+                sram += $2
+            }
+        }
+        END {print name, flash + 0, sram + 0}'
+done > "$REPORT"
+
+awk '
+    {printf "%-16s %7d %6d\n", $1, $2, $3}
+    $1 ~ /\.o$/ {objects++; flash += $2; sram += $3}
+    END {if (objects) printf "%-16s %7d %6d\n", "total .o", flash, sram}
+' "$REPORT" | (printf "%-16s %7s %6s\n" module flash sram; cat)
+
+# The symbols of each object, or of the image for LTO, biggest first.
+for file in "$@"; do
+    case $file in
+        *.o) ;;
+        *) [ "$LTO" = 1 ] || continue ;;
+    esac
+
+    echo
+    echo "$(basename "$file"):"
+    $NM --size-sort -S -r -f sysv "$file" | awk -F '|' "$SECTION_AWK"'
+        function hex(s,    i, n) {
+            n = 0
+            for (i = 1; i <= length(s); i++) {
+                n = n * 16 + index("0123456789abcdef", tolower(substr(s, i, 1))) - 1
+            }
+            return n
+        }
+        function trim(s) {
+            gsub(/^ +| +$/, "", s)
+            return s
+        }
+        NF >= 7 && trim($5) != "" {
+            section = trim($7)
+            w = where(section)
+            printf "    %-32s %6d  %s\n", trim($1), hex(trim($5)), w != "" ? w : section
+        }'
+done
+
+if [ "$UPDATE" = 1 ]; then
+    cp "$REPORT" "$BASELINE"
+    echo
+    echo "Wrote $BASELINE"
+    exit 0
+fi
+
+if [ ! -f "$BASELINE" ]; then
+    echo
+    echo "No $BASELINE to compare against.  Run make size-baseline on the commit to compare with, and commit $BASELINE." >&2
+    exit 1
+fi
+
+echo
+awk -v threshold="$THRESHOLD" -v lto="$LTO" '
+    FNR == NR {base_flash[$1] = $2; base_sram[$1] = $3; next}
+    $1 !~ /\.o$/ && lto {
+        if (!($1 in base_flash)) {
+            print "No " $1 " in the baseline, make size-baseline writes one."
+            exit 1
+        }
+        printf "%-16s flash %d -> %d (%+d), sram %d -> %d (%+d)\n", $1, base_flash[$1], $2,
+               $2 - base_flash[$1], base_sram[$1], $3, $3 - base_sram[$1]
+        if ($2 - base_flash[$1] > threshold || $3 - base_sram[$1] > threshold) {
+            failed = 1
+        }
+    }
+    $1 ~ /\.o$/ {
+        seen[$1] = 1
+        if ($1 in base_flash) {
+            check($1, $2 - base_flash[$1], $3 - base_sram[$1], "")
+        } else {
+            check($1, $2, $3, " (new)")
+        }
+    }
+    # Each module is checked once, and the total is the sum of their growth.
+    function check(name, flash_growth, sram_growth, note) {
+        total_flash += flash_growth; total_sram += sram_growth
+        if (flash_growth != 0 || sram_growth != 0) {
+            printf "%-16s flash %+d sram %+d%s\n", name, flash_growth, sram_growth, note
+        }
+        if (flash_growth > threshold || sram_growth > threshold) {
+            failed = 1
+        }
+    }
+    END {
+        if (!lto) {
+            for (name in base_flash) {
+                if (name ~ /\.o$/ && !(name in seen)) {
+                    check(name, -base_flash[name], -base_sram[name], " (removed)")
+                }
+            }
+            printf "%-16s flash %+d sram %+d\n", "total .o", total_flash, total_sram
+            if (total_flash > threshold || total_sram > threshold) {
+                failed = 1
+            }
+        }
+        if (failed) {
+            print "Grew by more than " threshold " bytes over the baseline"
+            exit 1
+        }
+    }
+' "$BASELINE" "$REPORT"